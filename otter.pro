@@ -37,27 +37,41 @@ SOURCES += src/main.cpp \
     src/core/BookmarksImporter.cpp \
     src/core/BookmarksManager.cpp \
     src/core/BookmarksModel.cpp \
+    src/core/ClearHistoryJob.cpp \
     src/core/ContentBlockingList.cpp \
     src/core/ContentBlockingManager.cpp \
     src/core/Console.cpp \
     src/core/CookieJar.cpp \
+    src/core/CookiesDatabase.cpp \
+    src/core/CookieStore.cpp \
+    src/core/DeferredNetworkReply.cpp \
+    src/core/FaviconsManager.cpp \
     src/core/FileSystemCompleterModel.cpp \
     src/core/GesturesManager.cpp \
+    src/core/HistoryBenchmark.cpp \
     src/core/HistoryManager.cpp \
     src/core/Importer.cpp \
     src/core/LocalListingNetworkReply.cpp \
     src/core/NetworkManager.cpp \
     src/core/NetworkManagerFactory.cpp \
+    src/core/NetworkMemoryCache.cpp \
+    src/core/NetworkPredictor.cpp \
     src/core/NetworkAutomaticProxy.cpp \
     src/core/NetworkCache.cpp \
     src/core/NetworkProxyFactory.cpp \
+    src/core/NetworkScheduler.cpp \
     src/core/Notification.cpp \
+    src/core/PageLoadBenchmark.cpp \
+    src/core/PageSnapshotServer.cpp \
+    src/core/PageSnapshotsManager.cpp \
     src/core/PlatformIntegration.cpp \
     src/core/SearchesManager.cpp \
     src/core/SearchSuggester.cpp \
     src/core/SessionsManager.cpp \
     src/core/SettingsManager.cpp \
     src/core/ShortcutsManager.cpp \
+    src/core/SnapshotNetworkReply.cpp \
+    src/core/TimersManager.cpp \
     src/core/TransfersManager.cpp \
     src/core/Utils.cpp \
     src/core/WebBackend.cpp \
@@ -145,12 +159,18 @@ HEADERS += src/core/Action.h \
     src/core/BookmarksImporter.h \
     src/core/BookmarksManager.h \
     src/core/BookmarksModel.h \
+    src/core/ClearHistoryJob.h \
     src/core/ContentBlockingList.h \
     src/core/ContentBlockingManager.h \
     src/core/Console.h \
     src/core/CookieJar.h \
+    src/core/CookiesDatabase.h \
+    src/core/CookieStore.h \
+    src/core/DeferredNetworkReply.h \
+    src/core/FaviconsManager.h \
     src/core/FileSystemCompleterModel.h \
     src/core/GesturesManager.h \
+    src/core/HistoryBenchmark.h \
     src/core/HistoryManager.h \
     src/core/Importer.h \
     src/core/LocalListingNetworkReply.h \
@@ -158,14 +178,22 @@ HEADERS += src/core/Action.h \
     src/core/NetworkCache.h \
     src/core/NetworkManager.h \
     src/core/NetworkManagerFactory.h \
+    src/core/NetworkMemoryCache.h \
+    src/core/NetworkPredictor.h \
     src/core/NetworkProxyFactory.h \
+    src/core/NetworkScheduler.h \
     src/core/Notification.h \
+    src/core/PageLoadBenchmark.h \
+    src/core/PageSnapshotServer.h \
+    src/core/PageSnapshotsManager.h \
     src/core/PlatformIntegration.h \
     src/core/SearchesManager.h \
     src/core/SearchSuggester.h \
     src/core/SessionsManager.h \
     src/core/SettingsManager.h \
     src/core/ShortcutsManager.h \
+    src/core/SnapshotNetworkReply.h \
+    src/core/TimersManager.h \
     src/core/TransfersManager.h \
     src/core/Utils.h \
     src/core/WebBackend.h \
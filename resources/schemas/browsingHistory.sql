@@ -1,4 +1,8 @@
 CREATE TABLE "visits" ("id" INTEGER PRIMARY KEY, "location" INTEGER NOT NULL, "icon" INTEGER NOT NULL, "title" TEXT, "time" INTEGER NOT NULL, "typed" BOOLEAN NOT NULL);
+CREATE INDEX "visits_location" ON "visits" ("location");
 CREATE TABLE "locations" ("id" INTEGER PRIMARY KEY, "host" INTEGER NOT NULL, "scheme" TEXT NOT NULL, "path" TEXT, UNIQUE("host", "scheme", "path"));
 CREATE TABLE "hosts" ("id" INTEGER PRIMARY KEY, "host" TEXT UNIQUE NOT NULL);
-CREATE TABLE "icons" ("id" INTEGER PRIMARY KEY, "icon" BLOB UNIQUE NOT NULL);
+CREATE TABLE "icons" ("id" INTEGER PRIMARY KEY, "hash" TEXT UNIQUE NOT NULL, "icon" BLOB NOT NULL);
+CREATE VIRTUAL TABLE "search" USING fts4("title", "url");
+CREATE TABLE "location_stats" ("location" INTEGER PRIMARY KEY, "title" TEXT, "visits" INTEGER NOT NULL, "typed" INTEGER NOT NULL, "time" INTEGER NOT NULL, "frecency" REAL NOT NULL);
+CREATE INDEX "location_stats_frecency" ON "location_stats" ("frecency");
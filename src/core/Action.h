@@ -79,6 +79,7 @@ enum ActionIdentifier
 	RedoAction,
 	InspectPageAction,
 	InspectElementAction,
+	ExportNetworkLogAction,
 	PrintAction,
 	PrintPreviewAction,
 	BookmarkAction,
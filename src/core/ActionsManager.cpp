@@ -97,6 +97,7 @@ ActionsManager::ActionsManager(MainWindow *parent) : QObject(parent),
 		registerAction(QLatin1String("FullScreen"), QT_TRANSLATE_NOOP("actions", "Full Screen"), QString(), Utils::getIcon(QLatin1String("view-fullscreen")));
 		registerAction(QLatin1String("ViewSource"), QT_TRANSLATE_NOOP("actions", "View Source"), QString(), QIcon(), false, false, false, ViewSourceAction);
 		registerAction(QLatin1String("InspectPage"), QT_TRANSLATE_NOOP("actions", "Inspect Page"), QString(), QIcon(), true, true, false, InspectPageAction);
+		registerAction(QLatin1String("ExportNetworkLog"), QT_TRANSLATE_NOOP("actions", "Export Network Log..."), QString(), QIcon(), true, false, false, ExportNetworkLogAction);
 		registerAction(QLatin1String("Sidebar"), QT_TRANSLATE_NOOP("actions", "Show Sidebar"), QString(), QIcon(), true, true, false);
 		registerAction(QLatin1String("Go"), QT_TRANSLATE_NOOP("actions", "Go"), QString(), Utils::getIcon(QLatin1String("go-jump-locationbar")), true, false, false, GoAction);
 		registerAction(QLatin1String("GoBack"), QT_TRANSLATE_NOOP("actions", "Back"), QString(), Utils::getIcon(QLatin1String("go-previous")), true, false, false, GoBackAction);
@@ -19,9 +19,12 @@
 
 #include "AddressCompletionModel.h"
 #include "BookmarksManager.h"
+#include "BookmarksModel.h"
+#include "HistoryManager.h"
 #include "SettingsManager.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QSet>
 
 namespace Otter
 {
@@ -29,47 +32,186 @@ namespace Otter
 AddressCompletionModel* AddressCompletionModel::m_instance = NULL;
 
 AddressCompletionModel::AddressCompletionModel(QObject *parent) : QAbstractListModel(parent),
-	m_updateTimer(0)
+	m_isBookmarksIndexed(false)
 {
-	m_updateTimer = startTimer(250);
-
-	connect(BookmarksManager::getInstance(), SIGNAL(modelModified()), this, SLOT(updateCompletion()));
+	connect(BookmarksManager::getInstance(), SIGNAL(modelModified()), this, SLOT(bookmarksModified()));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString)));
 }
 
-void AddressCompletionModel::timerEvent(QTimerEvent *event)
+void AddressCompletionModel::optionChanged(const QString &option)
+{
+	if (option.contains(QLatin1String("AddressField/Suggest")))
+	{
+		updateCompletion();
+	}
+}
+
+void AddressCompletionModel::bookmarksModified()
+{
+	m_bookmarks.clear();
+	m_isBookmarksIndexed = false;
+
+	updateCompletion();
+}
+
+void AddressCompletionModel::indexBookmarks(QStandardItem *branch)
 {
-	if (event->timerId() == m_updateTimer)
+	if (!branch)
+	{
+		return;
+	}
+
+	for (int i = 0; i < branch->rowCount(); ++i)
 	{
-		killTimer(m_updateTimer);
+		QStandardItem *item = branch->child(i);
 
-		m_updateTimer = 0;
+		if (!item)
+		{
+			continue;
+		}
 
-		QStringList urls;
-		urls << QLatin1String("about:bookmarks") << QLatin1String("about:cache") << QLatin1String("about:config") << QLatin1String("about:cookies") << QLatin1String("about:history") << QLatin1String("about:transfers");
-		urls << BookmarksManager::getUrls();
+		const BookmarksItem::BookmarkType type = static_cast<BookmarksItem::BookmarkType>(item->data(BookmarksModel::TypeRole).toInt());
 
-		beginResetModel();
+		if (type == BookmarksItem::FolderBookmark)
+		{
+			indexBookmarks(item);
+		}
+		else if (type == BookmarksItem::UrlBookmark)
+		{
+			const QString url = item->data(BookmarksModel::UrlRole).toUrl().toString();
 
-		m_urls = urls;
+			if (url.isEmpty())
+			{
+				continue;
+			}
+
+			QString address = url.toLower();
+
+			m_bookmarks.insert(address, url);
+
+			const int schemeSeparator = address.indexOf(QLatin1String("://"));
 
-		endResetModel();
+			if (schemeSeparator >= 0)
+			{
+				address = address.mid(schemeSeparator + 3);
+
+				m_bookmarks.insert(address, url);
+
+				if (address.startsWith(QLatin1String("www.")))
+				{
+					m_bookmarks.insert(address.mid(4), url);
+				}
+			}
+		}
 	}
 }
 
-void AddressCompletionModel::optionChanged(const QString &option)
+void AddressCompletionModel::updateCompletion()
 {
-	if (option.contains(QLatin1String("AddressField/Suggest")))
+	QStringList urls;
+	QSet<QString> completions;
+
+	if (!m_filter.isEmpty())
 	{
-		updateCompletion();
+		QStringList pages;
+		pages << QLatin1String("about:bookmarks") << QLatin1String("about:cache") << QLatin1String("about:config") << QLatin1String("about:cookies") << QLatin1String("about:history") << QLatin1String("about:transfers");
+
+		for (int i = 0; i < pages.count(); ++i)
+		{
+			if (pages.at(i).startsWith(m_filter, Qt::CaseInsensitive))
+			{
+				urls.append(pages.at(i));
+				completions.insert(pages.at(i));
+			}
+		}
+
+		if (SettingsManager::getValue(QLatin1String("AddressField/SuggestHistory")).toBool())
+		{
+			const QList<HistoryEntry> entries = HistoryManager::getCompletions(m_filter);
+
+			for (int i = 0; i < entries.count(); ++i)
+			{
+				const QString completion = getCompletion(entries.at(i).url.toString());
+
+				if (!completion.isEmpty() && !completions.contains(completion))
+				{
+					urls.append(completion);
+					completions.insert(completion);
+				}
+			}
+		}
+
+		if (SettingsManager::getValue(QLatin1String("AddressField/SuggestBookmarks")).toBool())
+		{
+			if (!m_isBookmarksIndexed)
+			{
+				indexBookmarks(BookmarksManager::getModel()->getRootItem());
+
+				m_isBookmarksIndexed = true;
+			}
+
+			const QString prefix = m_filter.toLower();
+			QMultiMap<QString, QString>::const_iterator iterator;
+			int amount = 0;
+
+			for (iterator = m_bookmarks.lowerBound(prefix); (iterator != m_bookmarks.constEnd() && iterator.key().startsWith(prefix) && amount < 10); ++iterator)
+			{
+				const QString completion = getCompletion(iterator.value());
+
+				if (!completion.isEmpty() && !completions.contains(completion))
+				{
+					urls.append(completion);
+					completions.insert(completion);
+
+					++amount;
+				}
+			}
+		}
+	}
+
+	if (urls == m_urls)
+	{
+		return;
+	}
+
+	const int oldCount = m_urls.count();
+
+	if (urls.count() > oldCount)
+	{
+		beginInsertRows(QModelIndex(), oldCount, (urls.count() - 1));
+
+		m_urls = urls;
+
+		endInsertRows();
+	}
+	else if (urls.count() < oldCount)
+	{
+		beginRemoveRows(QModelIndex(), urls.count(), (oldCount - 1));
+
+		m_urls = urls;
+
+		endRemoveRows();
+	}
+	else
+	{
+		m_urls = urls;
+	}
+
+	const int changedCount = qMin(oldCount, m_urls.count());
+
+	if (changedCount > 0)
+	{
+		emit dataChanged(index(0, 0), index((changedCount - 1), 0));
 	}
 }
 
-void AddressCompletionModel::updateCompletion()
+void AddressCompletionModel::setFilter(const QString &filter)
 {
-	if (m_updateTimer == 0)
+	if (filter != m_filter)
 	{
-		m_updateTimer = startTimer(250);
+		m_filter = filter;
+
+		updateCompletion();
 	}
 }
 
@@ -83,6 +225,40 @@ AddressCompletionModel* AddressCompletionModel::getInstance()
 	return m_instance;
 }
 
+QString AddressCompletionModel::getCompletion(const QString &url) const
+{
+	if (url.startsWith(m_filter, Qt::CaseInsensitive))
+	{
+		return url;
+	}
+
+	const int schemeSeparator = url.indexOf(QLatin1String("://"));
+
+	if (schemeSeparator < 0)
+	{
+		return QString();
+	}
+
+	QString completion = url.mid(schemeSeparator + 3);
+
+	if (completion.startsWith(m_filter, Qt::CaseInsensitive))
+	{
+		return completion;
+	}
+
+	if (completion.startsWith(QLatin1String("www.")))
+	{
+		completion.remove(0, 4);
+
+		if (completion.startsWith(m_filter, Qt::CaseInsensitive))
+		{
+			return completion;
+		}
+	}
+
+	return QString();
+}
+
 QVariant AddressCompletionModel::data(const QModelIndex &index, int role) const
 {
 	if (role == Qt::DisplayRole && index.column() == 0 && index.row() >= 0 && index.row() < m_urls.count())
@@ -21,6 +21,8 @@
 #define OTTER_ADDRESSCOMPLETIONMODEL_H
 
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QMultiMap>
+#include <QtGui/QStandardItem>
 
 namespace Otter
 {
@@ -30,23 +32,28 @@ class AddressCompletionModel : public QAbstractListModel
 	Q_OBJECT
 
 public:
+	void setFilter(const QString &filter);
 	static AddressCompletionModel* getInstance();
 	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
 	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
 	int rowCount(const QModelIndex &index = QModelIndex()) const;
 
 protected:
-	void timerEvent(QTimerEvent *event);
+	void indexBookmarks(QStandardItem *branch);
+	QString getCompletion(const QString &url) const;
 
 protected slots:
 	void optionChanged(const QString &option);
+	void bookmarksModified();
 	void updateCompletion();
 
 private:
 	explicit AddressCompletionModel(QObject *parent = NULL);
 
+	QString m_filter;
 	QStringList m_urls;
-	int m_updateTimer;
+	QMultiMap<QString, QString> m_bookmarks;
+	bool m_isBookmarksIndexed;
 
 	static AddressCompletionModel *m_instance;
 };
@@ -20,10 +20,15 @@
 #include "Application.h"
 #include "BookmarksManager.h"
 #include "Console.h"
+#include "FaviconsManager.h"
 #include "HistoryManager.h"
 #include "NetworkManagerFactory.h"
+#include "NetworkPredictor.h"
+#include "NetworkScheduler.h"
+#include "PageSnapshotsManager.h"
 #include "SearchesManager.h"
 #include "SettingsManager.h"
+#include "TimersManager.h"
 #include "TransfersManager.h"
 #include "WebBackendsManager.h"
 #include "./config.h"
@@ -108,6 +113,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	cachePath = QFileInfo(cachePath).absoluteFilePath();
 
+	const bool isBenchmark = (parser->isSet(QLatin1String("benchmark-history")) || parser->isSet(QLatin1String("benchmark-pages")));
+
 	delete parser;
 
 	QCryptographicHash hash(QCryptographicHash::Md5);
@@ -120,6 +127,11 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	if (socket.waitForConnected(500))
 	{
+		if (isBenchmark)
+		{
+			return;
+		}
+
 		const QStringList decodedArguments = arguments();
 		QStringList encodedArguments;
 
@@ -183,8 +195,18 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	SessionsManager::createInstance(profilePath, cachePath, this);
 
+	TimersManager::createInstance(this);
+
 	NetworkManagerFactory::createInstance(this);
 
+	NetworkScheduler::createInstance(this);
+
+	PageSnapshotsManager::createInstance(this);
+
+	NetworkPredictor::createInstance(this);
+
+	FaviconsManager::createInstance(this);
+
 	BookmarksManager::createInstance(this);
 
 	HistoryManager::createInstance(this);
@@ -471,6 +493,12 @@ QCommandLineParser* Application::getParser() const
 	parser->addOption(QCommandLineOption(QLatin1String("session"), QCoreApplication::translate("main", "Restores session <session> if it exists"), QLatin1String("session"), QString()));
 	parser->addOption(QCommandLineOption(QLatin1String("privatesession"), QCoreApplication::translate("main", "Starts private session")));
 	parser->addOption(QCommandLineOption(QLatin1String("portable"), QCoreApplication::translate("main", "Sets profile and cache paths to directories inside the same directory as that of application binary")));
+	parser->addOption(QCommandLineOption(QLatin1String("benchmark-history"), QCoreApplication::translate("main", "Measures browsing history storage performance using synthetic databases and writes report to <path>"), QLatin1String("path"), QString()));
+	parser->addOption(QCommandLineOption(QLatin1String("benchmark-history-sizes"), QCoreApplication::translate("main", "Comma separated amounts of visits of databases generated for history benchmark"), QLatin1String("sizes"), QLatin1String("10000,100000,1000000")));
+	parser->addOption(QCommandLineOption(QLatin1String("benchmark-pages"), QCoreApplication::translate("main", "Measures load time of pages listed in <path> in cold and warm cache"), QLatin1String("path"), QString()));
+	parser->addOption(QCommandLineOption(QLatin1String("benchmark-pages-report"), QCoreApplication::translate("main", "Writes report of pages benchmark to <path>"), QLatin1String("path"), QLatin1String("-")));
+	parser->addOption(QCommandLineOption(QLatin1String("benchmark-pages-iterations"), QCoreApplication::translate("main", "Amount of cold and warm loads of each page for pages benchmark"), QLatin1String("amount"), QLatin1String("3")));
+	parser->addOption(QCommandLineOption(QLatin1String("benchmark-pages-snapshots"), QCoreApplication::translate("main", "Serves recorded page snapshots from <path> through local HTTP server during pages benchmark"), QLatin1String("path"), QString()));
 
 	return parser;
 }
@@ -18,9 +18,8 @@
 **************************************************************************/
 
 #include "BookmarksModel.h"
+#include "FaviconsManager.h"
 #include "Utils.h"
-#include "WebBackend.h"
-#include "WebBackendsManager.h"
 
 #include <QtCore/QMimeData>
 
@@ -181,7 +180,7 @@ QVariant BookmarksItem::data(int role) const
 		}
 		else if (type == UrlBookmark)
 		{
-			return WebBackendsManager::getBackend()->getIconForUrl(data(BookmarksModel::UrlRole).toUrl());
+			return FaviconsManager::getIcon(data(BookmarksModel::UrlRole).toUrl());
 		}
 
 		return QVariant();
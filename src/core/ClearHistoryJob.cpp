@@ -0,0 +1,239 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ClearHistoryJob.h"
+#include "HistoryManager.h"
+#include "NetworkCache.h"
+#include "NetworkManagerFactory.h"
+#include "PageSnapshotsManager.h"
+#include "TransfersManager.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+ClearHistoryJob::ClearHistoryJob(const QStringList &clearSettings, int period, QObject *parent) : QObject(parent),
+	m_clearSettings(clearSettings),
+	m_period(period),
+	m_amount(0),
+	m_processed(0),
+	m_timer(0),
+	m_needsCacheCleanup(false),
+	m_needsCookiesCleanup(false),
+	m_needsHistoryCleanup(false)
+{
+}
+
+void ClearHistoryJob::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_timer)
+	{
+		return;
+	}
+
+	const int progress = getProgress();
+	QElapsedTimer timer;
+	timer.start();
+
+	while (timer.elapsed() < 15)
+	{
+		if (!processStep())
+		{
+			finish(false);
+
+			return;
+		}
+	}
+
+	if (getProgress() != progress)
+	{
+		emit progressChanged(getProgress());
+	}
+}
+
+void ClearHistoryJob::start()
+{
+	if (m_timer != 0)
+	{
+		return;
+	}
+
+	if (m_clearSettings.contains(QLatin1String("browsing")))
+	{
+		if (m_period > 0)
+		{
+			m_historyEntries = HistoryManager::getRecentEntries(m_period);
+		}
+
+		m_needsHistoryCleanup = m_historyEntries.isEmpty();
+	}
+
+	m_needsCookiesCleanup = m_clearSettings.contains(QLatin1String("cookies"));
+
+	if (m_clearSettings.contains(QLatin1String("downloads")))
+	{
+		const QList<TransferInformation*> transfers = TransfersManager::getTransfers();
+
+		for (int i = 0; i < transfers.count(); ++i)
+		{
+			if (transfers.at(i)->state == FinishedTransfer && (m_period == 0 || (transfers.at(i)->finished.isValid() && transfers.at(i)->finished.secsTo(QDateTime::currentDateTime()) > (m_period * 3600))))
+			{
+				m_transfers.append(transfers.at(i));
+			}
+		}
+	}
+
+	if (m_clearSettings.contains(QLatin1String("caches")))
+	{
+		m_cacheEntries = NetworkManagerFactory::getCache()->getEntries(m_period);
+		m_needsCacheCleanup = true;
+	}
+
+	m_amount = (m_historyEntries.count() + m_transfers.count() + m_cacheEntries.count() + (m_needsHistoryCleanup ? 1 : 0) + (m_needsCookiesCleanup ? 1 : 0) + (m_needsCacheCleanup ? 1 : 0));
+	m_processed = 0;
+	m_timer = startTimer(0);
+
+	emit progressChanged(0);
+}
+
+void ClearHistoryJob::cancel()
+{
+	if (m_timer != 0)
+	{
+		finish(true);
+	}
+}
+
+void ClearHistoryJob::finish(bool isCancelled)
+{
+	killTimer(m_timer);
+
+	m_timer = 0;
+	m_historyEntries.clear();
+	m_transfers.clear();
+	m_cacheEntries.clear();
+	m_needsHistoryCleanup = false;
+	m_needsCookiesCleanup = false;
+	m_needsCacheCleanup = false;
+
+	if (isCancelled)
+	{
+		emit cancelled();
+	}
+	else
+	{
+		emit progressChanged(100);
+		emit finished();
+	}
+}
+
+int ClearHistoryJob::getProgress() const
+{
+	return ((m_amount > 0) ? ((m_processed * 100) / m_amount) : 100);
+}
+
+bool ClearHistoryJob::processStep()
+{
+	if (!m_historyEntries.isEmpty())
+	{
+		const QList<qint64> entries = m_historyEntries.mid(0, 100);
+
+		m_historyEntries.erase(m_historyEntries.begin(), (m_historyEntries.begin() + entries.count()));
+
+		HistoryManager::removeEntries(entries);
+
+		m_processed += entries.count();
+
+		return true;
+	}
+
+	if (m_needsHistoryCleanup)
+	{
+		HistoryManager::clearHistory(m_period);
+
+		m_needsHistoryCleanup = false;
+
+		++m_processed;
+
+		return true;
+	}
+
+	if (m_needsCookiesCleanup)
+	{
+		NetworkManagerFactory::clearCookies(m_period);
+
+		m_needsCookiesCleanup = false;
+
+		++m_processed;
+
+		return true;
+	}
+
+	if (!m_transfers.isEmpty())
+	{
+		TransferInformation *transfer = m_transfers.takeFirst();
+
+		if (TransfersManager::getTransfers().contains(transfer))
+		{
+			TransfersManager::removeTransfer(transfer);
+		}
+
+		++m_processed;
+
+		return true;
+	}
+
+	if (!m_cacheEntries.isEmpty())
+	{
+		NetworkManagerFactory::getCache()->remove(m_cacheEntries.takeFirst());
+
+		++m_processed;
+
+		return true;
+	}
+
+	if (m_needsCacheCleanup)
+	{
+		if (m_period > 0)
+		{
+			PageSnapshotsManager::clearSnapshots(m_period);
+		}
+		else
+		{
+			NetworkManagerFactory::getCache()->clearCache();
+		}
+
+		m_needsCacheCleanup = false;
+
+		++m_processed;
+
+		return true;
+	}
+
+	return false;
+}
+
+bool ClearHistoryJob::isRunning() const
+{
+	return (m_timer != 0);
+}
+
+}
@@ -0,0 +1,72 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_CLEARHISTORYJOB_H
+#define OTTER_CLEARHISTORYJOB_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QUrl>
+
+namespace Otter
+{
+
+struct TransferInformation;
+
+class ClearHistoryJob : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit ClearHistoryJob(const QStringList &clearSettings, int period = 0, QObject *parent = NULL);
+
+	void start();
+	int getProgress() const;
+	bool isRunning() const;
+
+public slots:
+	void cancel();
+
+protected:
+	void timerEvent(QTimerEvent *event);
+	void finish(bool isCancelled);
+	bool processStep();
+
+private:
+	QStringList m_clearSettings;
+	QList<QUrl> m_cacheEntries;
+	QList<qint64> m_historyEntries;
+	QList<TransferInformation*> m_transfers;
+	int m_period;
+	int m_amount;
+	int m_processed;
+	int m_timer;
+	bool m_needsCacheCleanup;
+	bool m_needsCookiesCleanup;
+	bool m_needsHistoryCleanup;
+
+signals:
+	void progressChanged(int progress);
+	void finished();
+	void cancelled();
+};
+
+}
+
+#endif
@@ -18,104 +18,287 @@
 **************************************************************************/
 
 #include "CookieJar.h"
+#include "CookiesDatabase.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
+#include "TimersManager.h"
 
-#include <QtCore/QFile>
-#include <QtCore/QSaveFile>
+#include <QtCore/QDateTime>
+#include <QtCore/QThread>
 #include <QtCore/QTimerEvent>
 
 namespace Otter
 {
 
 CookieJar::CookieJar(bool isPrivate, QObject *parent) : QNetworkCookieJar(parent),
+	m_database(NULL),
+	m_databaseThread(NULL),
 	m_keepCookiesPolicy(UntilExpireKeepCookies),
 	m_thirdPartyCookiesAcceptPolicy(AlwaysAcceptCookies),
 	m_saveTimer(0),
+	m_cookiesPerDomainLimit(SettingsManager::getValue(QLatin1String("Network/CookiesPerDomainLimit")).toInt()),
+	m_clearDatabase(false),
 	m_enableCookies(true),
+	m_isLoaded(isPrivate),
 	m_isPrivate(isPrivate)
 {
+	TimersManager::addTask(this, "removeExpiredCookies", 300000);
+
 	if (isPrivate)
 	{
 		return;
 	}
 
-	QFile file(SessionsManager::getProfilePath() + QLatin1String("/cookies.dat"));
+	qRegisterMetaType<QList<QNetworkCookie> >("QList<QNetworkCookie>");
+
+	m_database = new CookiesDatabase(SessionsManager::getProfilePath() + QLatin1String("/cookies.sqlite"));
+	m_databaseThread = new QThread(this);
+
+	m_database->moveToThread(m_databaseThread);
+	m_databaseThread->start();
+
+	connect(m_database, SIGNAL(cookiesLoaded(QList<QNetworkCookie>,QStringList)), this, SLOT(addCookies(QList<QNetworkCookie>,QStringList)));
+	connect(m_database, SIGNAL(loadingFinished()), this, SLOT(finishLoading()));
 
-	if (!file.open(QIODevice::ReadOnly))
+	QMetaObject::invokeMethod(m_database, "open", Qt::QueuedConnection);
+
+	optionChanged(QLatin1String("Browser/EnableCookies"), SettingsManager::getValue(QLatin1String("Browser/EnableCookies")));
+	optionChanged(QLatin1String("Network/CookiesKeepMode"), SettingsManager::getValue(QLatin1String("Network/CookiesKeepMode")));
+	optionChanged(QLatin1String("Network/ThirdPartyCookiesPolicy"), SettingsManager::getValue(QLatin1String("Network/ThirdPartyCookiesPolicy")));
+
+	if (m_keepCookiesPolicy == UntilExitKeepCookies)
+	{
+		m_isLoaded = true;
+		m_clearDatabase = true;
+
+		saveCookies(Qt::QueuedConnection);
+	}
+
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+}
+
+CookieJar::CookieJar(CookieJar *sharedJar, QObject *parent) : QNetworkCookieJar(parent),
+	m_sharedJar(sharedJar),
+	m_database(NULL),
+	m_databaseThread(NULL),
+	m_keepCookiesPolicy(UntilExpireKeepCookies),
+	m_thirdPartyCookiesAcceptPolicy(AlwaysAcceptCookies),
+	m_saveTimer(0),
+	m_cookiesPerDomainLimit(0),
+	m_clearDatabase(false),
+	m_enableCookies(true),
+	m_isLoaded(true),
+	m_isPrivate(false)
+{
+	connect(sharedJar, SIGNAL(cookieAdded(QNetworkCookie)), this, SIGNAL(cookieAdded(QNetworkCookie)));
+	connect(sharedJar, SIGNAL(cookieRemoved(QNetworkCookie)), this, SIGNAL(cookieRemoved(QNetworkCookie)));
+}
+
+CookieJar::~CookieJar()
+{
+	if (!m_database)
 	{
 		return;
 	}
 
-	QList<QNetworkCookie> allCookies;
-	QDataStream stream(&file);
-	quint32 amount;
+	if (m_keepCookiesPolicy == UntilExitKeepCookies)
+	{
+		m_insertedCookies.clear();
+		m_removedCookies.clear();
+
+		m_clearDatabase = true;
+	}
+
+	saveCookies(Qt::BlockingQueuedConnection);
 
-	stream >> amount;
+	QMetaObject::invokeMethod(m_database, "close", Qt::BlockingQueuedConnection);
+
+	m_databaseThread->quit();
+	m_databaseThread->wait();
+
+	delete m_database;
+}
 
-	for (quint32 i = 0; i < amount; ++i)
+void CookieJar::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_saveTimer)
 	{
-		QByteArray value;
+		saveCookies(Qt::QueuedConnection);
+	}
+}
 
-		stream >> value;
+void CookieJar::scheduleSave(const QNetworkCookie &cookie, bool isRemoved)
+{
+	if (!m_database)
+	{
+		return;
+	}
 
-		const QList<QNetworkCookie> cookies = QNetworkCookie::parseCookies(value);
+	const QString key = getCookieKey(cookie);
 
-		for (int j = 0; j < cookies.count(); ++j)
-		{
-			allCookies.append(cookies.at(j));
-		}
+	if (isRemoved)
+	{
+		m_insertedCookies.remove(key);
+		m_removedCookies[key] = cookie;
+	}
+	else
+	{
+		m_removedCookies.remove(key);
+		m_insertedCookies[key] = cookie;
+	}
+
+	if (m_saveTimer == 0)
+	{
+		m_saveTimer = startTimer(500);
+	}
+}
+
+void CookieJar::saveCookies(Qt::ConnectionType type)
+{
+	if (m_saveTimer != 0)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+	}
+
+	if (!m_database || (!m_clearDatabase && m_insertedCookies.isEmpty() && m_removedCookies.isEmpty()))
+	{
+		return;
+	}
 
-		if (stream.atEnd())
+	QMetaObject::invokeMethod(m_database, "saveCookies", type, Q_ARG(QList<QNetworkCookie>, m_insertedCookies.values()), Q_ARG(QList<QNetworkCookie>, m_removedCookies.values()), Q_ARG(bool, m_clearDatabase));
+
+	m_insertedCookies.clear();
+	m_removedCookies.clear();
+
+	m_clearDatabase = false;
+}
+
+void CookieJar::removeExpiredCookies()
+{
+	const QDateTime currentDateTime = QDateTime::currentDateTimeUtc();
+
+	m_lock.lockForRead();
+
+	const QList<QNetworkCookie> cookies = m_store.getCookies();
+
+	m_lock.unlock();
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (!cookies.at(i).isSessionCookie() && cookies.at(i).expirationDate() <= currentDateTime)
 		{
-			break;
+			deleteCookie(cookies.at(i));
 		}
 	}
 
-	optionChanged(QLatin1String("Browser/EnableCookies"), SettingsManager::getValue(QLatin1String("Browser/EnableCookies")));
-	setAllCookies(allCookies);
-
-	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+	if (m_database)
+	{
+		QMetaObject::invokeMethod(m_database, "removeExpiredCookies", Qt::QueuedConnection);
+	}
 }
 
-void CookieJar::timerEvent(QTimerEvent *event)
+void CookieJar::removeExcessCookies(const QNetworkCookie &cookie)
 {
-	if (event->timerId() != m_saveTimer)
+	m_lock.lockForRead();
+
+	QList<QNetworkCookie> cookies = m_store.getSiteCookies(cookie.domain());
+
+	m_lock.unlock();
+
+	if (cookies.count() <= m_cookiesPerDomainLimit)
 	{
 		return;
 	}
 
-	killTimer(m_saveTimer);
+	qSort(cookies.begin(), cookies.end(), cookieExpirationOrder);
 
-	m_saveTimer = 0;
+	int amount = (cookies.count() - m_cookiesPerDomainLimit);
+
+	for (int i = 0; (i < cookies.count() && amount > 0); ++i)
+	{
+		if (!cookies.at(i).hasSameIdentifier(cookie))
+		{
+			deleteCookie(cookies.at(i));
 
-	QSaveFile file(SessionsManager::getProfilePath() + QLatin1String("/cookies.dat"));
+			--amount;
+		}
+	}
+}
 
-	if (!file.open(QIODevice::WriteOnly))
+void CookieJar::loadCookies(const QString &domain) const
+{
+	if (m_isLoaded)
 	{
 		return;
 	}
 
-	QList<QNetworkCookie> cookies = allCookies();
-	QDataStream stream(&file);
-	stream << quint32(cookies.size());
+	const QString registrableDomain = (domain.isEmpty() ? QString() : CookieStore::getRegistrableDomain(domain));
 
-	for (int i = 0; i < cookies.size(); ++i)
+	if (!registrableDomain.isEmpty() && m_loadedDomains.contains(registrableDomain))
 	{
-		stream << cookies.at(i).toRawForm();
+		return;
 	}
 
-	file.commit();
+	QList<QNetworkCookie> cookies;
+
+	QMetaObject::invokeMethod(m_database, "loadCookies", Qt::BlockingQueuedConnection, Q_RETURN_ARG(QList<QNetworkCookie>, cookies), Q_ARG(QStringList, (registrableDomain.isEmpty() ? QStringList() : QStringList(registrableDomain))));
+
+	QWriteLocker locker(&m_lock);
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (registrableDomain.isEmpty() && m_loadedDomains.contains(CookieStore::getRegistrableDomain(cookies.at(i).domain())))
+		{
+			continue;
+		}
+
+		m_store.addCookie(cookies.at(i));
+	}
+
+	if (registrableDomain.isEmpty())
+	{
+		m_loadedDomains.clear();
+
+		m_isLoaded = true;
+	}
+	else
+	{
+		m_loadedDomains.insert(registrableDomain);
+	}
 }
 
-void CookieJar::scheduleSave()
+void CookieJar::addCookies(const QList<QNetworkCookie> &cookies, const QStringList &domains)
 {
-	if (!m_isPrivate && m_saveTimer == 0)
+	if (m_isLoaded)
 	{
-		m_saveTimer = startTimer(500);
+		return;
+	}
+
+	QWriteLocker locker(&m_lock);
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (!m_loadedDomains.contains(CookieStore::getRegistrableDomain(cookies.at(i).domain())))
+		{
+			m_store.addCookie(cookies.at(i));
+		}
+	}
+
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		m_loadedDomains.insert(domains.at(i));
 	}
 }
 
+void CookieJar::finishLoading()
+{
+	m_loadedDomains.clear();
+
+	m_isLoaded = true;
+}
+
 void CookieJar::optionChanged(const QString &option, const QVariant &value)
 {
 	if (option == QLatin1String("Browser/PrivateMode"))
@@ -126,113 +309,286 @@ void CookieJar::optionChanged(const QString &option, const QVariant &value)
 	{
 		m_enableCookies = (value.toBool() && !SettingsManager::getValue(QLatin1String("Browser/PrivateMode")).toBool());
 	}
+	else if (option == QLatin1String("Network/CookiesKeepMode"))
+	{
+		m_keepCookiesPolicy = ((value.toString() == QLatin1String("keepUntilExit")) ? UntilExitKeepCookies : UntilExpireKeepCookies);
+	}
+	else if (option == QLatin1String("Network/CookiesPerDomainLimit"))
+	{
+		m_cookiesPerDomainLimit = value.toInt();
+	}
+	else if (option == QLatin1String("Network/ThirdPartyCookiesPolicy"))
+	{
+		if (value.toString() == QLatin1String("acceptExisting"))
+		{
+			m_thirdPartyCookiesAcceptPolicy = AcceptExistingCookies;
+		}
+		else if (value.toString() == QLatin1String("ignore"))
+		{
+			m_thirdPartyCookiesAcceptPolicy = NeverAcceptCookies;
+		}
+		else
+		{
+			m_thirdPartyCookiesAcceptPolicy = AlwaysAcceptCookies;
+		}
+	}
 }
 
 void CookieJar::clearCookies(int period)
 {
-	Q_UNUSED(period)
+	if (m_sharedJar)
+	{
+		m_sharedJar->clearCookies(period);
+
+		return;
+	}
 
-	setAllCookies(QList<QNetworkCookie>());
-	scheduleSave();
+	if (period > 0 && m_database)
+	{
+		loadCookies();
+		saveCookies(Qt::BlockingQueuedConnection);
+
+		QList<QNetworkCookie> cookies;
+
+		QMetaObject::invokeMethod(m_database, "removeCookies", Qt::BlockingQueuedConnection, Q_RETURN_ARG(QList<QNetworkCookie>, cookies), Q_ARG(int, period));
+
+		for (int i = 0; i < cookies.count(); ++i)
+		{
+			m_lock.lockForWrite();
+
+			const bool result = m_store.removeCookie(cookies.at(i));
+
+			m_lock.unlock();
+
+			if (result)
+			{
+				emit cookieRemoved(cookies.at(i));
+			}
+		}
+
+		return;
+	}
+
+	m_lock.lockForWrite();
+	m_store.clear();
+	m_lock.unlock();
+	m_loadedDomains.clear();
+
+	m_isLoaded = true;
+
+	if (m_database)
+	{
+		m_insertedCookies.clear();
+		m_removedCookies.clear();
+
+		m_clearDatabase = true;
+
+		saveCookies(Qt::QueuedConnection);
+	}
 }
 
 CookieJar* CookieJar::clone(QObject *parent)
 {
-	CookieJar *cookieJar = new CookieJar(m_isPrivate, parent);
-	cookieJar->setAllCookies(allCookies());
+	if (!m_isPrivate)
+	{
+		return new CookieJar((m_sharedJar ? m_sharedJar.data() : this), parent);
+	}
+
+	CookieJar *cookieJar = new CookieJar(true, parent);
+	cookieJar->m_store = m_store;
 
 	return cookieJar;
 }
 
 QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
 {
-	if (!m_enableCookies)
+	if (m_sharedJar)
+	{
+		return m_sharedJar->cookiesForUrl(url);
+	}
+
+	if (!m_enableCookies || url.host().isEmpty())
 	{
 		return QList<QNetworkCookie>();
 	}
 
-	return QNetworkCookieJar::cookiesForUrl(url);
+	loadCookies(url.host());
+
+	QReadLocker locker(&m_lock);
+
+	return m_store.getCookiesForUrl(url);
 }
 
 QList<QNetworkCookie> CookieJar::getCookies(const QString &domain) const
 {
-	if (!domain.isEmpty())
+	if (m_sharedJar)
 	{
-		const QList<QNetworkCookie> cookies = allCookies();
-		QList<QNetworkCookie> domainCookies;
+		return m_sharedJar->getCookies(domain);
+	}
 
-		for (int i = 0; i < cookies.length(); ++i)
-		{
-			if (cookies.at(i).domain() == domain || (cookies.at(i).domain().startsWith(QLatin1Char('.')) && domain.endsWith(cookies.at(i).domain())))
-			{
-				domainCookies.append(cookies.at(i));
-			}
-		}
+	loadCookies(domain);
 
-		return domainCookies;
-	}
+	QReadLocker locker(&m_lock);
+
+	return m_store.getCookies(domain);
+}
 
-	return allCookies();
+QString CookieJar::getCookieKey(const QNetworkCookie &cookie)
+{
+	return (cookie.domain() + QLatin1Char('\t') + cookie.path() + QLatin1Char('\t') + QString::fromLatin1(cookie.name().toHex()));
 }
 
 CookieJar::KeepCookiesPolicy CookieJar::getKeepCookiesPolicy() const
 {
+	if (m_sharedJar)
+	{
+		return m_sharedJar->getKeepCookiesPolicy();
+	}
+
 	return m_keepCookiesPolicy;
 }
 
 CookieJar::ThirdPartyCookiesAcceptPolicy CookieJar::getThirdPartyCookiesAcceptPolicy() const
 {
+	if (m_sharedJar)
+	{
+		return m_sharedJar->getThirdPartyCookiesAcceptPolicy();
+	}
+
 	return m_thirdPartyCookiesAcceptPolicy;
 }
 
+bool CookieJar::canAcceptCookies(const QUrl &url, const QUrl &firstPartyUrl) const
+{
+	if (m_sharedJar)
+	{
+		return m_sharedJar->canAcceptCookies(url, firstPartyUrl);
+	}
+
+	if (!m_enableCookies)
+	{
+		return false;
+	}
+
+	if (m_thirdPartyCookiesAcceptPolicy == AlwaysAcceptCookies || firstPartyUrl.host().isEmpty() || CookieStore::getRegistrableDomain(url.host()) == CookieStore::getRegistrableDomain(firstPartyUrl.host()))
+	{
+		return true;
+	}
+
+	if (m_thirdPartyCookiesAcceptPolicy == NeverAcceptCookies)
+	{
+		return false;
+	}
+
+	loadCookies(url.host());
+
+	QReadLocker locker(&m_lock);
+
+	return !m_store.getCookies(url.host()).isEmpty();
+}
+
 bool CookieJar::insertCookie(const QNetworkCookie &cookie)
 {
+	if (m_sharedJar)
+	{
+		return m_sharedJar->insertCookie(cookie);
+	}
+
 	if (!m_enableCookies)
 	{
 		return false;
 	}
 
-	const bool result = QNetworkCookieJar::insertCookie(cookie);
+	loadCookies(cookie.domain());
 
-	if (result)
+	if (!cookie.isSessionCookie() && cookie.expirationDate() < QDateTime::currentDateTimeUtc())
 	{
-		scheduleSave();
+		deleteCookie(cookie);
 
-		emit cookieAdded(cookie);
+		return false;
 	}
 
-	return result;
+	m_lock.lockForWrite();
+	m_store.addCookie(cookie);
+	m_lock.unlock();
+
+	scheduleSave(cookie, false);
+
+	emit cookieAdded(cookie);
+
+	if (m_cookiesPerDomainLimit > 0)
+	{
+		removeExcessCookies(cookie);
+	}
+
+	return true;
 }
 
 bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
 {
-	const bool result = QNetworkCookieJar::deleteCookie(cookie);
-
-	if (result)
+	if (m_sharedJar)
 	{
-		scheduleSave();
+		return m_sharedJar->deleteCookie(cookie);
+	}
+
+	loadCookies(cookie.domain());
 
-		emit cookieRemoved(cookie);
+	m_lock.lockForWrite();
+
+	const bool result = m_store.removeCookie(cookie);
+
+	m_lock.unlock();
+
+	if (!result)
+	{
+		return false;
 	}
 
-	return result;
+	scheduleSave(cookie, true);
+
+	emit cookieRemoved(cookie);
+
+	return true;
 }
 
 bool CookieJar::updateCookie(const QNetworkCookie &cookie)
 {
+	if (m_sharedJar)
+	{
+		return m_sharedJar->updateCookie(cookie);
+	}
+
 	if (!m_enableCookies)
 	{
 		return false;
 	}
 
-	const bool result = QNetworkCookieJar::updateCookie(cookie);
+	loadCookies(cookie.domain());
+
+	QWriteLocker locker(&m_lock);
+
+	if (!m_store.hasCookie(cookie))
+	{
+		return false;
+	}
+
+	m_store.addCookie(cookie);
+
+	locker.unlock();
+
+	scheduleSave(cookie, false);
 
-	if (result)
+	return true;
+}
+
+bool CookieJar::cookieExpirationOrder(const QNetworkCookie &first, const QNetworkCookie &second)
+{
+	if (first.isSessionCookie() || second.isSessionCookie())
 	{
-		scheduleSave();
+		return (!first.isSessionCookie() && second.isSessionCookie());
 	}
 
-	return result;
+	return (first.expirationDate() < second.expirationDate());
 }
 
 }
@@ -20,12 +20,20 @@
 #ifndef OTTER_COOKIEJAR_H
 #define OTTER_COOKIEJAR_H
 
+#include "CookieStore.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
 #include <QtNetwork/QNetworkCookie>
 #include <QtNetwork/QNetworkCookieJar>
 
 namespace Otter
 {
 
+class CookiesDatabase;
+
 class CookieJar : public QNetworkCookieJar
 {
 	Q_OBJECT
@@ -47,6 +55,7 @@ public:
 	};
 
 	explicit CookieJar(bool isPrivate, QObject *parent = NULL);
+	~CookieJar();
 
 	void clearCookies(int period = 0);
 	CookieJar* clone(QObject *parent = NULL);
@@ -54,22 +63,44 @@ public:
 	QList<QNetworkCookie> getCookies(const QString &domain = QString()) const;
 	KeepCookiesPolicy getKeepCookiesPolicy() const;
 	ThirdPartyCookiesAcceptPolicy getThirdPartyCookiesAcceptPolicy() const;
+	bool canAcceptCookies(const QUrl &url, const QUrl &firstPartyUrl) const;
 	bool insertCookie(const QNetworkCookie &cookie);
 	bool deleteCookie(const QNetworkCookie &cookie);
 	bool updateCookie(const QNetworkCookie &cookie);
 
 protected:
+	explicit CookieJar(CookieJar *sharedJar, QObject *parent);
+
 	void timerEvent(QTimerEvent *event);
-	void scheduleSave();
+	void scheduleSave(const QNetworkCookie &cookie, bool isRemoved);
+	void saveCookies(Qt::ConnectionType type);
+	void removeExcessCookies(const QNetworkCookie &cookie);
+	void loadCookies(const QString &domain = QString()) const;
+	static QString getCookieKey(const QNetworkCookie &cookie);
+	static bool cookieExpirationOrder(const QNetworkCookie &first, const QNetworkCookie &second);
 
 protected slots:
+	void addCookies(const QList<QNetworkCookie> &cookies, const QStringList &domains);
+	void finishLoading();
+	void removeExpiredCookies();
 	void optionChanged(const QString &option, const QVariant &value);
 
 private:
+	QPointer<CookieJar> m_sharedJar;
+	CookiesDatabase *m_database;
+	QThread *m_databaseThread;
+	mutable CookieStore m_store;
+	mutable QReadWriteLock m_lock;
+	mutable QSet<QString> m_loadedDomains;
+	QHash<QString, QNetworkCookie> m_insertedCookies;
+	QHash<QString, QNetworkCookie> m_removedCookies;
 	KeepCookiesPolicy m_keepCookiesPolicy;
 	ThirdPartyCookiesAcceptPolicy m_thirdPartyCookiesAcceptPolicy;
 	int m_saveTimer;
+	int m_cookiesPerDomainLimit;
+	bool m_clearDatabase;
 	bool m_enableCookies;
+	mutable bool m_isLoaded;
 	bool m_isPrivate;
 
 signals:
@@ -0,0 +1,255 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "CookieStore.h"
+
+#include <QtCore/QDateTime>
+
+namespace Otter
+{
+
+CookieStore::CookieStore()
+{
+}
+
+void CookieStore::clear()
+{
+	m_cookies.clear();
+}
+
+void CookieStore::addCookie(const QNetworkCookie &cookie)
+{
+	QList<QNetworkCookie> &cookies = m_cookies[getRegistrableDomain(cookie.domain())][cookie.domain()];
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (cookies.at(i).hasSameIdentifier(cookie))
+		{
+			cookies.removeAt(i);
+
+			break;
+		}
+	}
+
+	int position = 0;
+
+	while (position < cookies.count() && cookies.at(position).path().length() >= cookie.path().length())
+	{
+		++position;
+	}
+
+	cookies.insert(position, cookie);
+}
+
+QList<QNetworkCookie> CookieStore::getCookies(const QString &domain) const
+{
+	QList<QNetworkCookie> cookies;
+
+	if (domain.isEmpty())
+	{
+		QHash<QString, QHash<QString, QList<QNetworkCookie> > >::const_iterator iterator;
+
+		for (iterator = m_cookies.constBegin(); iterator != m_cookies.constEnd(); ++iterator)
+		{
+			QHash<QString, QList<QNetworkCookie> >::const_iterator domainsIterator;
+
+			for (domainsIterator = iterator.value().constBegin(); domainsIterator != iterator.value().constEnd(); ++domainsIterator)
+			{
+				cookies.append(domainsIterator.value());
+			}
+		}
+
+		return cookies;
+	}
+
+	const QHash<QString, QList<QNetworkCookie> > domains = m_cookies.value(getRegistrableDomain(domain));
+	QHash<QString, QList<QNetworkCookie> >::const_iterator iterator;
+
+	for (iterator = domains.constBegin(); iterator != domains.constEnd(); ++iterator)
+	{
+		if (isParentDomain(domain, iterator.key()))
+		{
+			if (cookies.isEmpty())
+			{
+				cookies = iterator.value();
+			}
+			else
+			{
+				cookies.append(iterator.value());
+			}
+		}
+	}
+
+	return cookies;
+}
+
+QList<QNetworkCookie> CookieStore::getCookiesForUrl(const QUrl &url) const
+{
+	QList<QNetworkCookie> cookies;
+	const QString host = url.host();
+	const QHash<QString, QList<QNetworkCookie> > domains = m_cookies.value(getRegistrableDomain(host));
+
+	if (domains.isEmpty())
+	{
+		return cookies;
+	}
+
+	const QDateTime currentDateTime = QDateTime::currentDateTimeUtc();
+	const QString path = url.path();
+	const bool isSecure = (url.scheme() == QLatin1String("https"));
+	QHash<QString, QList<QNetworkCookie> >::const_iterator iterator;
+
+	for (iterator = domains.constBegin(); iterator != domains.constEnd(); ++iterator)
+	{
+		if (!isParentDomain(host, iterator.key()))
+		{
+			continue;
+		}
+
+		const QList<QNetworkCookie> &domainCookies = iterator.value();
+
+		for (int i = 0; i < domainCookies.count(); ++i)
+		{
+			const QNetworkCookie &cookie = domainCookies.at(i);
+
+			if (!isParentPath(path, cookie.path()) || (cookie.isSecure() && !isSecure) || (!cookie.isSessionCookie() && currentDateTime > cookie.expirationDate()))
+			{
+				continue;
+			}
+
+			int position = 0;
+
+			while (position < cookies.count() && cookies.at(position).path().length() >= cookie.path().length())
+			{
+				++position;
+			}
+
+			cookies.insert(position, cookie);
+		}
+	}
+
+	return cookies;
+}
+
+QList<QNetworkCookie> CookieStore::getSiteCookies(const QString &domain) const
+{
+	QList<QNetworkCookie> cookies;
+	const QHash<QString, QList<QNetworkCookie> > domains = m_cookies.value(getRegistrableDomain(domain));
+	QHash<QString, QList<QNetworkCookie> >::const_iterator iterator;
+
+	for (iterator = domains.constBegin(); iterator != domains.constEnd(); ++iterator)
+	{
+		cookies.append(iterator.value());
+	}
+
+	return cookies;
+}
+
+QString CookieStore::getRegistrableDomain(const QString &domain)
+{
+	const QString host = (domain.startsWith(QLatin1Char('.')) ? domain.mid(1) : domain).toLower();
+	QUrl url;
+	url.setHost(host);
+
+	const QString topLevelDomain = url.topLevelDomain();
+
+	if (topLevelDomain.isEmpty() || !host.endsWith(topLevelDomain) || host.length() == topLevelDomain.length())
+	{
+		return host;
+	}
+
+	return (host.left(host.length() - topLevelDomain.length()).section(QLatin1Char('.'), -1) + topLevelDomain);
+}
+
+bool CookieStore::removeCookie(const QNetworkCookie &cookie)
+{
+	const QString registrableDomain = getRegistrableDomain(cookie.domain());
+
+	if (!m_cookies.contains(registrableDomain) || !m_cookies[registrableDomain].contains(cookie.domain()))
+	{
+		return false;
+	}
+
+	QHash<QString, QList<QNetworkCookie> > &domains = m_cookies[registrableDomain];
+	QList<QNetworkCookie> &cookies = domains[cookie.domain()];
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (cookies.at(i).hasSameIdentifier(cookie))
+		{
+			cookies.removeAt(i);
+
+			if (cookies.isEmpty())
+			{
+				domains.remove(cookie.domain());
+
+				if (domains.isEmpty())
+				{
+					m_cookies.remove(registrableDomain);
+				}
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CookieStore::hasCookie(const QNetworkCookie &cookie) const
+{
+	const QList<QNetworkCookie> cookies = m_cookies.value(getRegistrableDomain(cookie.domain())).value(cookie.domain());
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (cookies.at(i).hasSameIdentifier(cookie))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CookieStore::isParentDomain(const QString &domain, const QString &reference)
+{
+	if (!reference.startsWith(QLatin1Char('.')))
+	{
+		return (domain == reference);
+	}
+
+	return (domain.endsWith(reference) || domain == reference.mid(1));
+}
+
+bool CookieStore::isParentPath(const QString &path, const QString &reference)
+{
+	if (reference.isEmpty() || reference == QLatin1String("/"))
+	{
+		return true;
+	}
+
+	if (!path.startsWith(reference))
+	{
+		return false;
+	}
+
+	return (reference.endsWith(QLatin1Char('/')) || path.length() == reference.length() || path.at(reference.length()) == QLatin1Char('/'));
+}
+
+}
@@ -0,0 +1,52 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_COOKIESTORE_H
+#define OTTER_COOKIESTORE_H
+
+#include <QtCore/QHash>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkCookie>
+
+namespace Otter
+{
+
+class CookieStore
+{
+public:
+	CookieStore();
+
+	void clear();
+	void addCookie(const QNetworkCookie &cookie);
+	QList<QNetworkCookie> getCookies(const QString &domain = QString()) const;
+	QList<QNetworkCookie> getCookiesForUrl(const QUrl &url) const;
+	QList<QNetworkCookie> getSiteCookies(const QString &domain) const;
+	static QString getRegistrableDomain(const QString &domain);
+	bool removeCookie(const QNetworkCookie &cookie);
+	bool hasCookie(const QNetworkCookie &cookie) const;
+	static bool isParentDomain(const QString &domain, const QString &reference);
+	static bool isParentPath(const QString &path, const QString &reference);
+
+private:
+	QHash<QString, QHash<QString, QList<QNetworkCookie> > > m_cookies;
+};
+
+}
+
+#endif
@@ -0,0 +1,330 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "CookiesDatabase.h"
+#include "CookieStore.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
+
+namespace Otter
+{
+
+CookiesDatabase::CookiesDatabase(const QString &path, QObject *parent) : QObject(parent),
+	m_path(path),
+	m_connectionName(QStringLiteral("cookies-%1").arg(reinterpret_cast<quintptr>(this)))
+{
+}
+
+void CookiesDatabase::open()
+{
+	QSqlDatabase database = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), m_connectionName);
+	database.setDatabaseName(m_path);
+
+	if (!database.open())
+	{
+		emit loadingFinished();
+
+		return;
+	}
+
+	database.exec(QLatin1String("PRAGMA journal_mode = WAL;"));
+	database.exec(QLatin1String("PRAGMA synchronous = NORMAL;"));
+
+	if (!database.tables().contains(QLatin1String("cookies")))
+	{
+		database.exec(QLatin1String("CREATE TABLE \"cookies\" (\"registrable_domain\" TEXT NOT NULL, \"domain\" TEXT NOT NULL, \"path\" TEXT NOT NULL, \"name\" BLOB NOT NULL, \"value\" BLOB, \"expiration_date\" INTEGER, \"is_secure\" BOOLEAN NOT NULL, \"is_http_only\" BOOLEAN NOT NULL, \"creation_date\" INTEGER, PRIMARY KEY (\"domain\", \"path\", \"name\"));"));
+		database.exec(QLatin1String("CREATE INDEX \"cookies_registrable_domain\" ON \"cookies\" (\"registrable_domain\");"));
+
+		importCookies(QFileInfo(m_path).absoluteDir().filePath(QLatin1String("cookies.dat")));
+	}
+	else if (!database.record(QLatin1String("cookies")).contains(QLatin1String("creation_date")))
+	{
+		database.exec(QLatin1String("ALTER TABLE \"cookies\" ADD COLUMN \"creation_date\" INTEGER;"));
+	}
+
+	QSqlQuery query(database);
+	query.setForwardOnly(true);
+	query.prepare(QLatin1String("SELECT DISTINCT \"registrable_domain\" FROM \"cookies\";"));
+	query.exec();
+
+	while (query.next())
+	{
+		m_pendingDomains.append(query.value(0).toString());
+	}
+
+	loadNextCookies();
+}
+
+void CookiesDatabase::close()
+{
+	m_pendingDomains.clear();
+
+	{
+		QSqlDatabase database = QSqlDatabase::database(m_connectionName, false);
+
+		if (database.isOpen())
+		{
+			database.close();
+		}
+	}
+
+	QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+void CookiesDatabase::importCookies(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QList<QNetworkCookie> cookies;
+	QDataStream stream(&file);
+	quint32 amount;
+
+	stream >> amount;
+
+	for (quint32 i = 0; i < amount; ++i)
+	{
+		QByteArray value;
+
+		stream >> value;
+
+		cookies.append(QNetworkCookie::parseCookies(value));
+
+		if (stream.atEnd())
+		{
+			break;
+		}
+	}
+
+	saveCookies(cookies, QList<QNetworkCookie>(), false);
+}
+
+void CookiesDatabase::saveCookies(const QList<QNetworkCookie> &insertedCookies, const QList<QNetworkCookie> &removedCookies, bool clear)
+{
+	QSqlDatabase database = QSqlDatabase::database(m_connectionName, false);
+
+	if (!database.isOpen())
+	{
+		return;
+	}
+
+	database.transaction();
+
+	if (clear)
+	{
+		database.exec(QLatin1String("DELETE FROM \"cookies\";"));
+	}
+
+	if (!removedCookies.isEmpty())
+	{
+		QSqlQuery query(database);
+		query.prepare(QLatin1String("DELETE FROM \"cookies\" WHERE \"domain\" = ? AND \"path\" = ? AND \"name\" = ?;"));
+
+		for (int i = 0; i < removedCookies.count(); ++i)
+		{
+			query.bindValue(0, removedCookies.at(i).domain());
+			query.bindValue(1, removedCookies.at(i).path());
+			query.bindValue(2, removedCookies.at(i).name());
+			query.exec();
+		}
+	}
+
+	if (!insertedCookies.isEmpty())
+	{
+		QSqlQuery query(database);
+		query.prepare(QLatin1String("INSERT OR REPLACE INTO \"cookies\" (\"registrable_domain\", \"domain\", \"path\", \"name\", \"value\", \"expiration_date\", \"is_secure\", \"is_http_only\", \"creation_date\") VALUES (?, ?, ?, ?, ?, ?, ?, ?, COALESCE((SELECT \"creation_date\" FROM \"cookies\" WHERE \"domain\" = ? AND \"path\" = ? AND \"name\" = ?), ?));"));
+
+		const qint64 currentTime = (QDateTime::currentMSecsSinceEpoch() / 1000);
+
+		for (int i = 0; i < insertedCookies.count(); ++i)
+		{
+			const QNetworkCookie &cookie = insertedCookies.at(i);
+
+			query.bindValue(0, CookieStore::getRegistrableDomain(cookie.domain()));
+			query.bindValue(1, cookie.domain());
+			query.bindValue(2, cookie.path());
+			query.bindValue(3, cookie.name());
+			query.bindValue(4, cookie.value());
+			query.bindValue(5, (cookie.isSessionCookie() ? QVariant(QVariant::LongLong) : QVariant(cookie.expirationDate().toMSecsSinceEpoch() / 1000)));
+			query.bindValue(6, cookie.isSecure());
+			query.bindValue(7, cookie.isHttpOnly());
+			query.bindValue(8, cookie.domain());
+			query.bindValue(9, cookie.path());
+			query.bindValue(10, cookie.name());
+			query.bindValue(11, currentTime);
+			query.exec();
+		}
+	}
+
+	database.commit();
+}
+
+void CookiesDatabase::removeExpiredCookies()
+{
+	QSqlDatabase database = QSqlDatabase::database(m_connectionName, false);
+
+	if (!database.isOpen())
+	{
+		return;
+	}
+
+	QSqlQuery query(database);
+	query.prepare(QLatin1String("DELETE FROM \"cookies\" WHERE \"expiration_date\" IS NOT NULL AND \"expiration_date\" <= ?;"));
+	query.bindValue(0, (QDateTime::currentMSecsSinceEpoch() / 1000));
+	query.exec();
+}
+
+void CookiesDatabase::loadNextCookies()
+{
+	if (m_pendingDomains.isEmpty())
+	{
+		emit loadingFinished();
+
+		return;
+	}
+
+	const QStringList domains = m_pendingDomains.mid(0, 50);
+
+	m_pendingDomains.erase(m_pendingDomains.begin(), (m_pendingDomains.begin() + domains.count()));
+
+	emit cookiesLoaded(readCookies(domains), domains);
+
+	QMetaObject::invokeMethod(this, "loadNextCookies", Qt::QueuedConnection);
+}
+
+QList<QNetworkCookie> CookiesDatabase::loadCookies(const QStringList &domains)
+{
+	if (domains.isEmpty())
+	{
+		m_pendingDomains.clear();
+	}
+	else
+	{
+		for (int i = 0; i < domains.count(); ++i)
+		{
+			m_pendingDomains.removeAll(domains.at(i));
+		}
+	}
+
+	return readCookies(domains);
+}
+
+QList<QNetworkCookie> CookiesDatabase::removeCookies(int period)
+{
+	QList<QNetworkCookie> cookies;
+	QSqlDatabase database = QSqlDatabase::database(m_connectionName, false);
+
+	if (!database.isOpen())
+	{
+		return cookies;
+	}
+
+	const qint64 time = ((QDateTime::currentMSecsSinceEpoch() / 1000) - (period * 3600));
+	QSqlQuery selectQuery(database);
+	selectQuery.setForwardOnly(true);
+	selectQuery.prepare(QLatin1String("SELECT \"domain\", \"path\", \"name\" FROM \"cookies\" WHERE \"creation_date\" >= ?;"));
+	selectQuery.bindValue(0, time);
+	selectQuery.exec();
+
+	while (selectQuery.next())
+	{
+		QNetworkCookie cookie(selectQuery.value(2).toByteArray());
+		cookie.setDomain(selectQuery.value(0).toString());
+		cookie.setPath(selectQuery.value(1).toString());
+
+		cookies.append(cookie);
+	}
+
+	QSqlQuery deleteQuery(database);
+	deleteQuery.prepare(QLatin1String("DELETE FROM \"cookies\" WHERE \"creation_date\" >= ?;"));
+	deleteQuery.bindValue(0, time);
+	deleteQuery.exec();
+
+	return cookies;
+}
+
+QList<QNetworkCookie> CookiesDatabase::readCookies(const QStringList &domains)
+{
+	QList<QNetworkCookie> cookies;
+	QSqlDatabase database = QSqlDatabase::database(m_connectionName, false);
+
+	if (!database.isOpen())
+	{
+		return cookies;
+	}
+
+	const qint64 currentTime = (QDateTime::currentMSecsSinceEpoch() / 1000);
+	int offset = 0;
+
+	do
+	{
+		const QStringList chunk = domains.mid(offset, 100);
+		QStringList placeholders;
+
+		for (int i = 0; i < chunk.count(); ++i)
+		{
+			placeholders.append(QLatin1String("?"));
+		}
+
+		QSqlQuery query(database);
+		query.setForwardOnly(true);
+		query.prepare(QStringLiteral("SELECT \"domain\", \"path\", \"name\", \"value\", \"expiration_date\", \"is_secure\", \"is_http_only\" FROM \"cookies\" WHERE %1(\"expiration_date\" IS NULL OR \"expiration_date\" > ?);").arg(chunk.isEmpty() ? QString() : QStringLiteral("\"registrable_domain\" IN (%1) AND ").arg(placeholders.join(QLatin1String(", ")))));
+
+		for (int i = 0; i < chunk.count(); ++i)
+		{
+			query.bindValue(i, chunk.at(i));
+		}
+
+		query.bindValue(chunk.count(), currentTime);
+		query.exec();
+
+		while (query.next())
+		{
+			QNetworkCookie cookie(query.value(2).toByteArray(), query.value(3).toByteArray());
+			cookie.setDomain(query.value(0).toString());
+			cookie.setPath(query.value(1).toString());
+			cookie.setSecure(query.value(5).toBool());
+			cookie.setHttpOnly(query.value(6).toBool());
+
+			if (!query.value(4).isNull())
+			{
+				cookie.setExpirationDate(QDateTime::fromMSecsSinceEpoch(query.value(4).toLongLong() * 1000));
+			}
+
+			cookies.append(cookie);
+		}
+
+		offset += 100;
+	}
+	while (offset < domains.count());
+
+	return cookies;
+}
+
+}
@@ -0,0 +1,64 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_COOKIESDATABASE_H
+#define OTTER_COOKIESDATABASE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtNetwork/QNetworkCookie>
+
+namespace Otter
+{
+
+class CookiesDatabase : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit CookiesDatabase(const QString &path, QObject *parent = NULL);
+
+public slots:
+	void open();
+	void close();
+	void saveCookies(const QList<QNetworkCookie> &insertedCookies, const QList<QNetworkCookie> &removedCookies, bool clear);
+	void removeExpiredCookies();
+	QList<QNetworkCookie> loadCookies(const QStringList &domains);
+	QList<QNetworkCookie> removeCookies(int period);
+
+protected:
+	void importCookies(const QString &path);
+	QList<QNetworkCookie> readCookies(const QStringList &domains);
+
+protected slots:
+	void loadNextCookies();
+
+private:
+	QString m_path;
+	QString m_connectionName;
+	QStringList m_pendingDomains;
+
+signals:
+	void cookiesLoaded(const QList<QNetworkCookie> &cookies, const QStringList &domains);
+	void loadingFinished();
+};
+
+}
+
+#endif
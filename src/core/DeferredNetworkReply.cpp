@@ -0,0 +1,231 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "DeferredNetworkReply.h"
+
+namespace Otter
+{
+
+DeferredNetworkReply::DeferredNetworkReply(QNetworkAccessManager *transportManager, QNetworkAccessManager::Operation operation, const QNetworkRequest &request, int priority, QWidget *widget, QObject *parent) : QNetworkReply(parent),
+	m_transportManager(transportManager),
+	m_widget(widget),
+	m_priority(priority),
+	m_ignoreSslErrors(false),
+	m_hasSslConfiguration(false)
+{
+	setRequest(request);
+	setUrl(request.url());
+	setOperation(operation);
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void DeferredNetworkReply::start(QNetworkRequest::Priority priority)
+{
+	if (m_reply || isFinished())
+	{
+		return;
+	}
+
+	QNetworkRequest mutableRequest(request());
+	mutableRequest.setPriority(priority);
+
+	m_reply = ((operation() == QNetworkAccessManager::HeadOperation) ? m_transportManager->head(mutableRequest) : m_transportManager->get(mutableRequest));
+	m_reply->setParent(this);
+
+	if (readBufferSize() > 0)
+	{
+		m_reply->setReadBufferSize(readBufferSize());
+	}
+
+	if (m_hasSslConfiguration)
+	{
+		m_reply->setSslConfiguration(m_sslConfiguration);
+	}
+
+	if (m_ignoreSslErrors)
+	{
+		m_reply->ignoreSslErrors();
+	}
+	else if (!m_ignoredSslErrors.isEmpty())
+	{
+		m_reply->ignoreSslErrors(m_ignoredSslErrors);
+	}
+
+	connect(m_reply, SIGNAL(metaDataChanged()), this, SLOT(replyMetaDataChanged()));
+	connect(m_reply, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+	connect(m_reply, SIGNAL(downloadProgress(qint64,qint64)), this, SIGNAL(downloadProgress(qint64,qint64)));
+	connect(m_reply, SIGNAL(uploadProgress(qint64,qint64)), this, SIGNAL(uploadProgress(qint64,qint64)));
+	connect(m_reply, SIGNAL(sslErrors(QList<QSslError>)), this, SIGNAL(sslErrors(QList<QSslError>)));
+	connect(m_reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(replyError(QNetworkReply::NetworkError)));
+	connect(m_reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+}
+
+void DeferredNetworkReply::abort()
+{
+	if (m_reply)
+	{
+		m_reply->abort();
+
+		return;
+	}
+
+	if (isFinished())
+	{
+		return;
+	}
+
+	setError(OperationCanceledError, tr("Operation canceled"));
+	setFinished(true);
+
+	emit error(OperationCanceledError);
+	emit finished();
+}
+
+void DeferredNetworkReply::ignoreSslErrors()
+{
+	m_ignoreSslErrors = true;
+
+	if (m_reply)
+	{
+		m_reply->ignoreSslErrors();
+	}
+}
+
+void DeferredNetworkReply::ignoreSslErrorsImplementation(const QList<QSslError> &errors)
+{
+	m_ignoredSslErrors = errors;
+
+	if (m_reply)
+	{
+		m_reply->ignoreSslErrors(errors);
+	}
+}
+
+void DeferredNetworkReply::setSslConfigurationImplementation(const QSslConfiguration &configuration)
+{
+	m_sslConfiguration = configuration;
+	m_hasSslConfiguration = true;
+
+	if (m_reply)
+	{
+		m_reply->setSslConfiguration(configuration);
+	}
+}
+
+void DeferredNetworkReply::sslConfigurationImplementation(QSslConfiguration &configuration) const
+{
+	if (m_reply)
+	{
+		configuration = m_reply->sslConfiguration();
+	}
+	else if (m_hasSslConfiguration)
+	{
+		configuration = m_sslConfiguration;
+	}
+}
+
+void DeferredNetworkReply::updateMetaData()
+{
+	const QList<QNetworkReply::RawHeaderPair> headers = m_reply->rawHeaderPairs();
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		setRawHeader(headers.at(i).first, headers.at(i).second);
+	}
+
+	QList<QNetworkRequest::Attribute> attributes;
+	attributes << QNetworkRequest::HttpStatusCodeAttribute << QNetworkRequest::HttpReasonPhraseAttribute << QNetworkRequest::RedirectionTargetAttribute << QNetworkRequest::ConnectionEncryptedAttribute << QNetworkRequest::SourceIsFromCacheAttribute << QNetworkRequest::HttpPipeliningWasUsedAttribute;
+#if QT_VERSION >= 0x050300
+	attributes << QNetworkRequest::SpdyWasUsedAttribute;
+#endif
+
+	for (int i = 0; i < attributes.count(); ++i)
+	{
+		const QVariant value = m_reply->attribute(attributes.at(i));
+
+		if (value.isValid())
+		{
+			setAttribute(attributes.at(i), value);
+		}
+	}
+}
+
+void DeferredNetworkReply::replyMetaDataChanged()
+{
+	updateMetaData();
+
+	emit metaDataChanged();
+}
+
+void DeferredNetworkReply::replyError(QNetworkReply::NetworkError code)
+{
+	setError(code, m_reply->errorString());
+
+	emit error(code);
+}
+
+void DeferredNetworkReply::replyFinished()
+{
+	updateMetaData();
+	setFinished(true);
+
+	emit finished();
+}
+
+void DeferredNetworkReply::setReadBufferSize(qint64 size)
+{
+	QNetworkReply::setReadBufferSize(size);
+
+	if (m_reply)
+	{
+		m_reply->setReadBufferSize(size);
+	}
+}
+
+QWidget* DeferredNetworkReply::getWidget() const
+{
+	return m_widget;
+}
+
+qint64 DeferredNetworkReply::bytesAvailable() const
+{
+	return (QNetworkReply::bytesAvailable() + (m_reply ? m_reply->bytesAvailable() : 0));
+}
+
+qint64 DeferredNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (!m_reply)
+	{
+		return (isFinished() ? -1 : 0);
+	}
+
+	return m_reply->read(data, maxSize);
+}
+
+int DeferredNetworkReply::getPriority() const
+{
+	return m_priority;
+}
+
+bool DeferredNetworkReply::isSequential() const
+{
+	return true;
+}
+
+}
@@ -0,0 +1,75 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_DEFERREDNETWORKREPLY_H
+#define OTTER_DEFERREDNETWORKREPLY_H
+
+#include <QtCore/QPointer>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QSslConfiguration>
+#include <QtWidgets/QWidget>
+
+namespace Otter
+{
+
+class DeferredNetworkReply : public QNetworkReply
+{
+	Q_OBJECT
+
+public:
+	DeferredNetworkReply(QNetworkAccessManager *transportManager, QNetworkAccessManager::Operation operation, const QNetworkRequest &request, int priority, QWidget *widget, QObject *parent = NULL);
+
+	void start(QNetworkRequest::Priority priority);
+	void setReadBufferSize(qint64 size);
+	QWidget* getWidget() const;
+	qint64 bytesAvailable() const;
+	int getPriority() const;
+	bool isSequential() const;
+
+public slots:
+	void abort();
+	void ignoreSslErrors();
+
+protected:
+	void ignoreSslErrorsImplementation(const QList<QSslError> &errors);
+	void setSslConfigurationImplementation(const QSslConfiguration &configuration);
+	void sslConfigurationImplementation(QSslConfiguration &configuration) const;
+	void updateMetaData();
+	qint64 readData(char *data, qint64 maxSize);
+
+protected slots:
+	void replyMetaDataChanged();
+	void replyError(QNetworkReply::NetworkError code);
+	void replyFinished();
+
+private:
+	QNetworkAccessManager *m_transportManager;
+	QPointer<QNetworkReply> m_reply;
+	QPointer<QWidget> m_widget;
+	QList<QSslError> m_ignoredSslErrors;
+	QSslConfiguration m_sslConfiguration;
+	int m_priority;
+	bool m_ignoreSslErrors;
+	bool m_hasSslConfiguration;
+};
+
+}
+
+#endif
@@ -0,0 +1,167 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "FaviconsManager.h"
+#include "WebBackend.h"
+#include "WebBackendsManager.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QThreadPool>
+#include <QtGui/QPixmap>
+
+namespace Otter
+{
+
+FaviconsManager* FaviconsManager::m_instance = NULL;
+QCache<QByteArray, QIcon> FaviconsManager::m_icons(256);
+QCache<QString, QIcon> FaviconsManager::m_urlIcons(256);
+int FaviconsManager::m_requestIdentifier = 0;
+
+FaviconTask::FaviconTask(int request, const QImage &image) : QRunnable(),
+	m_image(image),
+	m_request(request)
+{
+}
+
+void FaviconTask::run()
+{
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+
+	m_image.save(&buffer, "PNG");
+
+	QMetaObject::invokeMethod(FaviconsManager::getInstance(), "taskFinished", Qt::QueuedConnection, Q_ARG(int, m_request), Q_ARG(QByteArray, FaviconsManager::getHash(m_image)), Q_ARG(QByteArray, data), Q_ARG(QImage, m_image));
+}
+
+FaviconsManager::FaviconsManager(QObject *parent) : QObject(parent)
+{
+}
+
+void FaviconsManager::createInstance(QObject *parent)
+{
+	if (!m_instance)
+	{
+		m_instance = new FaviconsManager(parent);
+	}
+}
+
+void FaviconsManager::taskFinished(int request, const QByteArray &hash, const QByteArray &data, const QImage &image)
+{
+	if (!m_icons.contains(hash))
+	{
+		m_icons.insert(hash, new QIcon(QPixmap::fromImage(image)));
+	}
+
+	emit iconStored(request, hash, data);
+}
+
+void FaviconsManager::setIcon(const QUrl &url, const QIcon &icon)
+{
+	if (icon.isNull() || !url.isValid())
+	{
+		return;
+	}
+
+	m_urlIcons.insert(getUrlKey(url), new QIcon(icon));
+}
+
+FaviconsManager* FaviconsManager::getInstance()
+{
+	return m_instance;
+}
+
+QString FaviconsManager::getUrlKey(const QUrl &url)
+{
+	return url.adjusted(QUrl::RemoveFragment | QUrl::RemovePassword).toString();
+}
+
+QIcon FaviconsManager::getIcon(const QUrl &url)
+{
+	const QString key = getUrlKey(url);
+	QIcon *icon = m_urlIcons.object(key);
+
+	if (icon)
+	{
+		return *icon;
+	}
+
+	const QIcon backendIcon = WebBackendsManager::getBackend()->getIconForUrl(url);
+
+	if (!backendIcon.isNull())
+	{
+		m_urlIcons.insert(key, new QIcon(backendIcon));
+	}
+
+	return backendIcon;
+}
+
+QIcon FaviconsManager::getIcon(const QByteArray &hash, const QByteArray &data)
+{
+	if (hash.isEmpty() || data.isEmpty())
+	{
+		return QIcon();
+	}
+
+	QIcon *icon = m_icons.object(hash);
+
+	if (icon)
+	{
+		return *icon;
+	}
+
+	QPixmap pixmap;
+	pixmap.loadFromData(data);
+
+	const QIcon decodedIcon(pixmap);
+
+	if (!decodedIcon.isNull())
+	{
+		m_icons.insert(hash, new QIcon(decodedIcon));
+	}
+
+	return decodedIcon;
+}
+
+QByteArray FaviconsManager::getHash(const QImage &image)
+{
+	const QImage normalizedImage = image.convertToFormat(QImage::Format_ARGB32);
+
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(reinterpret_cast<const char*>(normalizedImage.constBits()), normalizedImage.byteCount());
+
+	return hash.result().toHex();
+}
+
+int FaviconsManager::storeIcon(const QIcon &icon)
+{
+	if (icon.isNull())
+	{
+		return -1;
+	}
+
+	++m_requestIdentifier;
+
+	QThreadPool::globalInstance()->start(new FaviconTask(m_requestIdentifier, icon.pixmap(QSize(16, 16)).toImage()));
+
+	return m_requestIdentifier;
+}
+
+}
@@ -0,0 +1,78 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_FAVICONSMANAGER_H
+#define OTTER_FAVICONSMANAGER_H
+
+#include <QtCore/QCache>
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QUrl>
+#include <QtGui/QIcon>
+#include <QtGui/QImage>
+
+namespace Otter
+{
+
+class FaviconTask : public QRunnable
+{
+public:
+	explicit FaviconTask(int request, const QImage &image);
+
+	void run();
+
+private:
+	QImage m_image;
+	int m_request;
+};
+
+class FaviconsManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance(QObject *parent = NULL);
+	static void setIcon(const QUrl &url, const QIcon &icon);
+	static FaviconsManager* getInstance();
+	static QIcon getIcon(const QUrl &url);
+	static QIcon getIcon(const QByteArray &hash, const QByteArray &data);
+	static QByteArray getHash(const QImage &image);
+	static int storeIcon(const QIcon &icon);
+
+protected:
+	explicit FaviconsManager(QObject *parent = NULL);
+
+	static QString getUrlKey(const QUrl &url);
+
+protected slots:
+	void taskFinished(int request, const QByteArray &hash, const QByteArray &data, const QImage &image);
+
+private:
+	static FaviconsManager *m_instance;
+	static QCache<QByteArray, QIcon> m_icons;
+	static QCache<QString, QIcon> m_urlIcons;
+	static int m_requestIdentifier;
+
+signals:
+	void iconStored(int request, const QByteArray &hash, const QByteArray &data);
+};
+
+}
+
+#endif
@@ -0,0 +1,342 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryBenchmark.h"
+#include "HistoryManager.h"
+#include "SettingsManager.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
+
+namespace Otter
+{
+
+int HistoryBenchmark::run(const QString &path, const QList<int> &sizes)
+{
+	if (!SettingsManager::getValue(QLatin1String("History/RememberBrowsing"), QUrl(QLatin1String("http://host0.example.com/"))).toBool())
+	{
+		QTextStream(stderr) << QCoreApplication::translate("main", "History benchmark requires browsing history to be remembered, enable it in this profile or use --profile to select another one.") << endl;
+
+		return 1;
+	}
+
+	QTemporaryDir directory;
+
+	if (!directory.isValid())
+	{
+		return 1;
+	}
+
+	const QStringList journalModes = QStringList() << QLatin1String("DELETE") << QLatin1String("TRUNCATE") << QLatin1String("PERSIST") << QLatin1String("MEMORY") << QLatin1String("WAL") << QLatin1String("OFF");
+	const bool wasEnabled = HistoryManager::m_enabled;
+	QJsonArray generation;
+	QJsonArray results;
+
+	closeDatabase();
+
+	HistoryManager::m_enabled = true;
+
+	qsrand(0);
+
+	for (int i = 0; i < sizes.count(); ++i)
+	{
+		const QString templatePath = directory.path() + QStringLiteral("/template-%1.sqlite").arg(sizes.at(i));
+
+		generation.append(generateDatabase(templatePath, sizes.at(i)));
+
+		for (int j = 0; j < journalModes.count(); ++j)
+		{
+			const QString databasePath = directory.path() + QStringLiteral("/browsingHistory-%1-%2.sqlite").arg(sizes.at(i)).arg(journalModes.at(j));
+
+			QFile::copy(templatePath, databasePath);
+
+			results.append(measureDatabase(databasePath, journalModes.at(j), sizes.at(i)));
+
+			QFile::remove(databasePath);
+			QFile::remove(databasePath + QLatin1String("-journal"));
+			QFile::remove(databasePath + QLatin1String("-wal"));
+			QFile::remove(databasePath + QLatin1String("-shm"));
+		}
+
+		QFile::remove(templatePath);
+	}
+
+	HistoryManager::m_enabled = wasEnabled;
+
+	QJsonObject report;
+	report.insert(QLatin1String("date"), QDateTime::currentDateTime().toString(Qt::ISODate));
+	report.insert(QLatin1String("generation"), generation);
+	report.insert(QLatin1String("results"), results);
+
+	const QByteArray data = QJsonDocument(report).toJson();
+
+	if (path == QLatin1String("-"))
+	{
+		QTextStream(stdout) << data;
+
+		return 0;
+	}
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return 1;
+	}
+
+	file.write(data);
+	file.close();
+
+	return 0;
+}
+
+void HistoryBenchmark::closeDatabase()
+{
+	if (QSqlDatabase::contains(QLatin1String("browsingHistory")))
+	{
+		QSqlDatabase::database(QLatin1String("browsingHistory"), false).close();
+		QSqlDatabase::removeDatabase(QLatin1String("browsingHistory"));
+	}
+}
+
+QJsonObject HistoryBenchmark::generateDatabase(const QString &path, int visits)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	HistoryManager::openDatabase(path, QLatin1String("OFF"));
+
+	{
+		QSqlDatabase database = QSqlDatabase::database(QLatin1String("browsingHistory"));
+		const int hosts = qMax(10, (visits / 100));
+		const int locations = qMax(hosts, (visits / 5));
+		const uint time = QDateTime::currentDateTime().toTime_t();
+
+		database.transaction();
+
+		QSqlQuery hostsQuery(database);
+		hostsQuery.prepare(QLatin1String("INSERT INTO \"hosts\" (\"id\", \"host\") VALUES(?, ?);"));
+
+		for (int i = 0; i < hosts; ++i)
+		{
+			hostsQuery.bindValue(0, i);
+			hostsQuery.bindValue(1, QStringLiteral("host%1.example.com").arg(i));
+			hostsQuery.exec();
+		}
+
+		QSqlQuery locationsQuery(database);
+		locationsQuery.prepare(QLatin1String("INSERT INTO \"locations\" (\"id\", \"host\", \"scheme\", \"path\") VALUES(?, ?, 'http', ?);"));
+
+		for (int i = 0; i < locations; ++i)
+		{
+			locationsQuery.bindValue(0, i);
+			locationsQuery.bindValue(1, (i % hosts));
+			locationsQuery.bindValue(2, QStringLiteral("/page/%1").arg(i));
+			locationsQuery.exec();
+		}
+
+		QSqlQuery visitsQuery(database);
+		visitsQuery.prepare(QLatin1String("INSERT INTO \"visits\" (\"id\", \"location\", \"icon\", \"title\", \"time\", \"typed\") VALUES(?, ?, 0, ?, ?, ?);"));
+
+		for (int i = 0; i < visits; ++i)
+		{
+			const double sample = (getRandomNumber(1000000) / 1000000.0);
+			const int location = qMin((locations - 1), static_cast<int>(sample * sample * sample * locations));
+
+			visitsQuery.bindValue(0, i);
+			visitsQuery.bindValue(1, location);
+			visitsQuery.bindValue(2, QStringLiteral("Page %1 on host %2").arg(location).arg(location % hosts));
+			visitsQuery.bindValue(3, (time - static_cast<uint>(getRandomNumber(31536000))));
+			visitsQuery.bindValue(4, (getRandomNumber(10) == 0));
+			visitsQuery.exec();
+		}
+
+		database.commit();
+		database.exec(QLatin1String("DROP TABLE \"search\";"));
+		database.exec(QLatin1String("DROP TABLE \"location_stats\";"));
+	}
+
+	closeDatabase();
+
+	HistoryManager::openDatabase(path, QLatin1String("OFF"));
+
+	closeDatabase();
+
+	QJsonObject result;
+	result.insert(QLatin1String("visits"), visits);
+	result.insert(QLatin1String("milliseconds"), timer.elapsed());
+	result.insert(QLatin1String("fileSize"), QFileInfo(path).size());
+
+	return result;
+}
+
+QJsonObject HistoryBenchmark::measureDatabase(const QString &path, const QString &journalMode, int visits)
+{
+	const int operations = 1000;
+	QJsonObject result;
+	result.insert(QLatin1String("visits"), visits);
+	result.insert(QLatin1String("journalMode"), journalMode);
+
+	HistoryManager::openDatabase(path, journalMode);
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QList<qint64> entries;
+
+	for (int i = 0; i < operations; ++i)
+	{
+		entries.append(HistoryManager::addEntry(QUrl(QStringLiteral("http://added%1.example.com/page/%2").arg(i % 10).arg(i)), QStringLiteral("Added page %1").arg(i), QIcon(), (i % 10 == 0)));
+	}
+
+	result.insert(QLatin1String("addEntry"), getThroughput(operations, timer.nsecsElapsed()));
+
+	timer.restart();
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		HistoryManager::updateEntry(entries.at(i), QUrl(QStringLiteral("http://added%1.example.com/page/%2").arg(i % 10).arg(i)), QStringLiteral("Updated page %1").arg(i), QIcon());
+	}
+
+	result.insert(QLatin1String("updateEntry"), getThroughput(entries.count(), timer.nsecsElapsed()));
+
+	const int hosts = qMax(10, (visits / 100));
+	const int locations = qMax(hosts, (visits / 5));
+
+	timer.restart();
+
+	for (int i = 0; i < operations; ++i)
+	{
+		const int location = getRandomNumber(locations * 2);
+
+		HistoryManager::hasUrl(QUrl(QStringLiteral("http://host%1.example.com/page/%2").arg(location % hosts).arg(location)));
+	}
+
+	result.insert(QLatin1String("hasUrl"), getThroughput(operations, timer.nsecsElapsed()));
+
+	const qint64 memoryUsage = getMemoryUsage();
+
+	timer.restart();
+
+	{
+		const QList<HistoryEntry> allEntries = HistoryManager::getEntries();
+
+		QJsonObject getEntriesResult;
+		getEntriesResult.insert(QLatin1String("milliseconds"), timer.elapsed());
+		getEntriesResult.insert(QLatin1String("entries"), allEntries.count());
+		getEntriesResult.insert(QLatin1String("memoryUsage"), ((memoryUsage < 0) ? -1 : (getMemoryUsage() - memoryUsage)));
+
+		result.insert(QLatin1String("getEntries"), getEntriesResult);
+	}
+
+	int amount = 0;
+
+	{
+		QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+		query.exec(QLatin1String("SELECT COUNT(*) AS \"amount\" FROM \"visits\";"));
+
+		if (query.next())
+		{
+			amount = query.record().value(QLatin1String("amount")).toInt();
+		}
+	}
+
+	timer.restart();
+
+	HistoryManager::getInstance()->removeOldEntries(QDateTime::currentDateTime().addDays(-330));
+
+	QJsonObject expiryResult;
+	expiryResult.insert(QLatin1String("milliseconds"), timer.elapsed());
+
+	{
+		QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+		query.exec(QLatin1String("SELECT COUNT(*) AS \"amount\" FROM \"visits\";"));
+
+		if (query.next())
+		{
+			expiryResult.insert(QLatin1String("removedVisits"), (amount - query.record().value(QLatin1String("amount")).toInt()));
+		}
+	}
+
+	result.insert(QLatin1String("expiry"), expiryResult);
+
+	timer.restart();
+
+	HistoryManager::getInstance()->cleanup();
+
+	QJsonObject cleanupResult;
+	cleanupResult.insert(QLatin1String("milliseconds"), timer.elapsed());
+
+	result.insert(QLatin1String("cleanup"), cleanupResult);
+
+	closeDatabase();
+
+	result.insert(QLatin1String("fileSize"), QFileInfo(path).size());
+
+	return result;
+}
+
+QJsonObject HistoryBenchmark::getThroughput(int operations, qint64 time)
+{
+	QJsonObject result;
+	result.insert(QLatin1String("operations"), operations);
+	result.insert(QLatin1String("milliseconds"), (time / 1000000.0));
+	result.insert(QLatin1String("operationsPerSecond"), ((time > 0) ? (operations * 1000000000.0 / time) : 0.0));
+	result.insert(QLatin1String("averageMicroseconds"), ((operations > 0) ? (time / 1000.0 / operations) : 0.0));
+
+	return result;
+}
+
+qint64 HistoryBenchmark::getMemoryUsage()
+{
+	QFile file(QLatin1String("/proc/self/status"));
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return -1;
+	}
+
+	while (!file.atEnd())
+	{
+		const QString line = QString(file.readLine());
+
+		if (line.startsWith(QLatin1String("VmRSS:")))
+		{
+			return (line.section(QLatin1Char(' '), 1, -1, QString::SectionSkipEmpty).section(QLatin1Char(' '), 0, 0).toLongLong() * 1024);
+		}
+	}
+
+	return -1;
+}
+
+int HistoryBenchmark::getRandomNumber(int maximum)
+{
+	return static_cast<int>((((static_cast<quint32>(qrand()) & 0x7FFF) << 15) | (static_cast<quint32>(qrand()) & 0x7FFF)) % static_cast<quint32>(qMax(1, maximum)));
+}
+
+}
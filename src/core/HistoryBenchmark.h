@@ -0,0 +1,45 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYBENCHMARK_H
+#define OTTER_HISTORYBENCHMARK_H
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QStringList>
+
+namespace Otter
+{
+
+class HistoryBenchmark
+{
+public:
+	static int run(const QString &path, const QList<int> &sizes);
+
+protected:
+	static void closeDatabase();
+	static QJsonObject generateDatabase(const QString &path, int visits);
+	static QJsonObject measureDatabase(const QString &path, const QString &journalMode, int visits);
+	static QJsonObject getThroughput(int operations, qint64 time);
+	static qint64 getMemoryUsage();
+	static int getRandomNumber(int maximum);
+};
+
+}
+
+#endif
@@ -18,13 +18,17 @@
 **************************************************************************/
 
 #include "HistoryManager.h"
+#include "Console.h"
+#include "FaviconsManager.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
-#include <QtCore/QBuffer>
 #include <QtCore/QFile>
+#include <QtCore/QRegularExpression>
+#include <QtCore/qmath.h>
 #include <QtCore/QTimerEvent>
 #include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
 #include <QtSql/QSqlField>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlResult>
@@ -35,6 +39,7 @@ namespace Otter
 HistoryManager* HistoryManager::m_instance = NULL;
 bool HistoryManager::m_enabled = false;
 bool HistoryManager::m_storeFavicons = true;
+bool HistoryManager::m_hasSearchIndex = false;
 
 HistoryManager::HistoryManager(QObject *parent) : QObject(parent),
 	m_cleanupTimer(0)
@@ -45,6 +50,7 @@ HistoryManager::HistoryManager(QObject *parent) : QObject(parent),
 	optionChanged(QLatin1String("History/StoreFavicons"));
 
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString)));
+	connect(FaviconsManager::getInstance(), SIGNAL(iconStored(int,QByteArray,QByteArray)), this, SLOT(updateIcon(int,QByteArray,QByteArray)));
 }
 
 void HistoryManager::createInstance(QObject *parent)
@@ -63,31 +69,7 @@ void HistoryManager::timerEvent(QTimerEvent *event)
 
 		m_cleanupTimer = 0;
 
-		QSqlDatabase database = QSqlDatabase::database(QLatin1String("browsingHistory"));
-
-		if (!database.isValid())
-		{
-			return;
-		}
-
-		QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
-		query.prepare(QLatin1String("SELECT COUNT(*) AS \"amount\" FROM \"visits\";"));
-		query.exec();
-
-		if (query.next())
-		{
-			const int amount = query.record().field(QLatin1String("amount")).value().toInt();
-
-			if (amount > SettingsManager::getValue(QLatin1String("History/BrowsingLimitAmountGlobal")).toInt())
-			{
-				removeOldEntries();
-			}
-		}
-
-		database.exec(QLatin1String("DELETE FROM \"icons\" WHERE \"id\" NOT IN(SELECT DISTINCT \"icon\" FROM \"visits\");"));
-		database.exec(QLatin1String("DELETE FROM \"locations\" WHERE \"id\" NOT IN(SELECT DISTINCT \"location\" FROM \"visits\");"));
-		database.exec(QLatin1String("DELETE FROM \"hosts\" WHERE \"id\" NOT IN(SELECT DISTINCT \"host\" FROM \"locations\");"));
-		database.exec(QLatin1String("VACUUM;"));
+		cleanup();
 	}
 	else if (event->timerId() == m_dayTimer)
 	{
@@ -109,6 +91,37 @@ void HistoryManager::scheduleCleanup()
 	}
 }
 
+void HistoryManager::cleanup()
+{
+	QSqlDatabase database = QSqlDatabase::database(QLatin1String("browsingHistory"));
+
+	if (!database.isValid())
+	{
+		return;
+	}
+
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QLatin1String("SELECT COUNT(*) AS \"amount\" FROM \"visits\";"));
+	query.exec();
+
+	if (query.next())
+	{
+		const int amount = query.record().field(QLatin1String("amount")).value().toInt();
+
+		if (amount > SettingsManager::getValue(QLatin1String("History/BrowsingLimitAmountGlobal")).toInt())
+		{
+			removeOldEntries();
+		}
+	}
+
+	database.exec(QLatin1String("DELETE FROM \"icons\" WHERE \"id\" NOT IN(SELECT DISTINCT \"icon\" FROM \"visits\");"));
+	database.exec(QLatin1String("DELETE FROM \"locations\" WHERE \"id\" NOT IN(SELECT DISTINCT \"location\" FROM \"visits\");"));
+	database.exec(QLatin1String("DELETE FROM \"hosts\" WHERE \"id\" NOT IN(SELECT DISTINCT \"host\" FROM \"locations\");"));
+	database.exec(QLatin1String("DELETE FROM \"location_stats\" WHERE \"location\" NOT IN(SELECT \"id\" FROM \"locations\");"));
+
+	database.exec(QLatin1String("VACUUM;"));
+}
+
 void HistoryManager::removeOldEntries(const QDateTime &date)
 {
 	int timestamp = (date.isValid() ? date.toTime_t() : 0);
@@ -144,6 +157,191 @@ void HistoryManager::removeOldEntries(const QDateTime &date)
 	removeEntries(entries);
 }
 
+void HistoryManager::openDatabase(const QString &path, const QString &journalMode)
+{
+	QSqlDatabase database = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), QLatin1String("browsingHistory"));
+	database.setDatabaseName(path);
+	database.open();
+	database.exec(QStringLiteral("PRAGMA journal_mode = %1;").arg(journalMode));
+
+	if (!database.tables().contains(QLatin1String("visits")))
+	{
+		QFile file(QLatin1String(":/schemas/browsingHistory.sql"));
+		file.open(QIODevice::ReadOnly);
+
+		const QStringList queries = QString(file.readAll()).split(QLatin1String(";\n"));
+
+		for (int i = 0; i < queries.count(); ++i)
+		{
+			database.exec(queries.at(i));
+		}
+	}
+	else if (!database.record(QLatin1String("icons")).contains(QLatin1String("hash")))
+	{
+		database.exec(QLatin1String("ALTER TABLE \"icons\" ADD COLUMN \"hash\" TEXT;"));
+
+		QSqlQuery selectQuery(database);
+		selectQuery.prepare(QLatin1String("SELECT \"id\", \"icon\" FROM \"icons\";"));
+		selectQuery.exec();
+
+		database.transaction();
+
+		while (selectQuery.next())
+		{
+			QImage image;
+			image.loadFromData(selectQuery.record().field(QLatin1String("icon")).value().toByteArray());
+
+			QSqlQuery updateQuery(database);
+			updateQuery.prepare(QLatin1String("UPDATE \"icons\" SET \"hash\" = ? WHERE \"id\" = ?;"));
+			updateQuery.bindValue(0, QString(FaviconsManager::getHash(image)));
+			updateQuery.bindValue(1, selectQuery.record().field(QLatin1String("id")).value());
+			updateQuery.exec();
+		}
+
+		database.exec(QLatin1String("UPDATE \"visits\" SET \"icon\" = (SELECT MIN(\"duplicates\".\"id\") FROM \"icons\" INNER JOIN \"icons\" AS \"duplicates\" ON \"icons\".\"hash\" = \"duplicates\".\"hash\" WHERE \"icons\".\"id\" = \"visits\".\"icon\") WHERE \"icon\" IN(SELECT \"id\" FROM \"icons\");"));
+		database.exec(QLatin1String("DELETE FROM \"icons\" WHERE \"id\" NOT IN(SELECT MIN(\"id\") FROM \"icons\" GROUP BY \"hash\");"));
+		database.commit();
+
+		QSqlQuery indexQuery(database);
+
+		if (!indexQuery.exec(QLatin1String("CREATE UNIQUE INDEX \"icons_hash\" ON \"icons\" (\"hash\");")))
+		{
+			Console::addMessage(tr("Failed to create index of history icons: %1").arg(indexQuery.lastError().text()), OtherMessageCategory, ErrorMessageLevel);
+		}
+	}
+
+	if (!database.tables().contains(QLatin1String("search")))
+	{
+		database.exec(QLatin1String("CREATE VIRTUAL TABLE \"search\" USING fts4(\"title\", \"url\");"));
+		database.exec(QLatin1String("INSERT INTO \"search\" (\"docid\", \"title\", \"url\") SELECT \"visits\".\"id\", \"visits\".\"title\", \"locations\".\"scheme\" || '://' || \"hosts\".\"host\" || \"locations\".\"path\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\";"));
+	}
+
+	m_hasSearchIndex = database.tables().contains(QLatin1String("search"));
+
+	database.exec(QLatin1String("CREATE INDEX IF NOT EXISTS \"visits_location\" ON \"visits\" (\"location\");"));
+
+	if (!database.tables().contains(QLatin1String("location_stats")))
+	{
+		database.exec(QLatin1String("CREATE TABLE \"location_stats\" (\"location\" INTEGER PRIMARY KEY, \"title\" TEXT, \"visits\" INTEGER NOT NULL, \"typed\" INTEGER NOT NULL, \"time\" INTEGER NOT NULL, \"frecency\" REAL NOT NULL);"));
+		database.exec(QLatin1String("CREATE INDEX \"location_stats_frecency\" ON \"location_stats\" (\"frecency\");"));
+
+		database.transaction();
+		database.exec(QLatin1String("INSERT INTO \"location_stats\" (\"location\", \"title\", \"visits\", \"typed\", \"time\", \"frecency\") SELECT \"location\", \"title\", COUNT(*), SUM(\"typed\"), MAX(\"time\"), 0 FROM \"visits\" GROUP BY \"location\";"));
+
+		QSqlQuery selectQuery(database);
+		selectQuery.prepare(QLatin1String("SELECT \"location\", \"time\", \"typed\" FROM \"visits\" ORDER BY \"location\" ASC, \"time\" ASC;"));
+		selectQuery.exec();
+
+		QSqlQuery updateQuery(database);
+		updateQuery.prepare(QLatin1String("UPDATE \"location_stats\" SET \"frecency\" = ? WHERE \"location\" = ?;"));
+
+		qint64 location = -1;
+		double frecency = 0;
+
+		while (selectQuery.next())
+		{
+			const qint64 currentLocation = selectQuery.record().field(QLatin1String("location")).value().toLongLong();
+
+			if (currentLocation != location)
+			{
+				if (location >= 0)
+				{
+					updateQuery.bindValue(0, frecency);
+					updateQuery.bindValue(1, location);
+					updateQuery.exec();
+				}
+
+				location = currentLocation;
+				frecency = 0;
+			}
+
+			frecency = addFrecency(frecency, selectQuery.record().field(QLatin1String("typed")).value().toBool(), selectQuery.record().field(QLatin1String("time")).value().toUInt());
+		}
+
+		if (location >= 0)
+		{
+			updateQuery.bindValue(0, frecency);
+			updateQuery.bindValue(1, location);
+			updateQuery.exec();
+		}
+
+		database.commit();
+	}
+}
+
+void HistoryManager::scheduleIcon(qint64 entry, const QIcon &icon)
+{
+	if (!m_storeFavicons || entry < 0 || icon.isNull())
+	{
+		return;
+	}
+
+	const int request = FaviconsManager::storeIcon(icon);
+
+	if (request >= 0)
+	{
+		m_instance->m_iconRequests[request] = entry;
+	}
+}
+
+void HistoryManager::updateStatistics(qint64 location, const QString &title, bool typed, uint time)
+{
+	QSqlQuery selectQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	selectQuery.prepare(QLatin1String("SELECT \"frecency\" FROM \"location_stats\" WHERE \"location\" = ?;"));
+	selectQuery.bindValue(0, location);
+	selectQuery.exec();
+
+	if (selectQuery.first())
+	{
+		QSqlQuery updateQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+		updateQuery.prepare(QLatin1String("UPDATE \"location_stats\" SET \"title\" = ?, \"visits\" = (\"visits\" + 1), \"typed\" = (\"typed\" + ?), \"time\" = MAX(\"time\", ?), \"frecency\" = ? WHERE \"location\" = ?;"));
+		updateQuery.bindValue(0, title);
+		updateQuery.bindValue(1, (typed ? 1 : 0));
+		updateQuery.bindValue(2, time);
+		updateQuery.bindValue(3, addFrecency(selectQuery.record().field(QLatin1String("frecency")).value().toDouble(), typed, time));
+		updateQuery.bindValue(4, location);
+		updateQuery.exec();
+
+		return;
+	}
+
+	QSqlQuery insertQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	insertQuery.prepare(QLatin1String("INSERT INTO \"location_stats\" (\"location\", \"title\", \"visits\", \"typed\", \"time\", \"frecency\") VALUES(?, ?, 1, ?, ?, ?);"));
+	insertQuery.bindValue(0, location);
+	insertQuery.bindValue(1, title);
+	insertQuery.bindValue(2, (typed ? 1 : 0));
+	insertQuery.bindValue(3, time);
+	insertQuery.bindValue(4, addFrecency(0, typed, time));
+	insertQuery.exec();
+}
+
+void HistoryManager::cleanupStatistics(const QList<qint64> &locations)
+{
+	if (locations.isEmpty())
+	{
+		return;
+	}
+
+	QStringList list;
+
+	for (int i = 0; i < locations.count(); ++i)
+	{
+		list.append(QString::number(locations.at(i)));
+	}
+
+	QSqlDatabase database = QSqlDatabase::database(QLatin1String("browsingHistory"));
+	database.exec(QStringLiteral("UPDATE \"location_stats\" SET \"time\" = (SELECT MAX(\"visits\".\"time\") FROM \"visits\" WHERE \"visits\".\"location\" = \"location_stats\".\"location\") WHERE \"location\" IN(%1);").arg(list.join(QLatin1String(", "))));
+	database.exec(QStringLiteral("DELETE FROM \"location_stats\" WHERE \"location\" IN(%1) AND \"visits\" <= 0;").arg(list.join(QLatin1String(", "))));
+}
+
+void HistoryManager::removeSearchEntries(const QString &condition)
+{
+	if (m_hasSearchIndex)
+	{
+		QSqlDatabase::database(QLatin1String("browsingHistory")).exec(QStringLiteral("DELETE FROM \"search\" WHERE \"docid\" IN(SELECT \"id\" FROM \"visits\" WHERE %1);").arg(condition));
+	}
+}
+
 void HistoryManager::clearHistory(int period)
 {
 	QSqlDatabase database = QSqlDatabase::database(QLatin1String("browsingHistory"));
@@ -162,7 +360,14 @@ void HistoryManager::clearHistory(int period)
 	{
 		if (period > 0)
 		{
-			database.exec(QStringLiteral("DELETE FROM \"visits\" WHERE \"time\" >= %1;").arg(QDateTime::currentDateTime().toTime_t() - (period * 3600)));
+			const QString condition = QStringLiteral("\"time\" >= %1").arg(QDateTime::currentDateTime().toTime_t() - (period * 3600));
+			const QList<qint64> locations = removeStatistics(condition);
+
+			removeSearchEntries(condition);
+
+			database.exec(QStringLiteral("DELETE FROM \"visits\" WHERE %1;").arg(condition));
+
+			cleanupStatistics(locations);
 
 			m_instance->scheduleCleanup();
 		}
@@ -172,6 +377,13 @@ void HistoryManager::clearHistory(int period)
 			database.exec(QLatin1String("DELETE FROM \"locations\";"));
 			database.exec(QLatin1String("DELETE FROM \"hosts\";"));
 			database.exec(QLatin1String("DELETE FROM \"icons\";"));
+			database.exec(QLatin1String("DELETE FROM \"location_stats\";"));
+
+			if (m_hasSearchIndex)
+			{
+				database.exec(QLatin1String("DELETE FROM \"search\";"));
+			}
+
 			database.exec(QLatin1String("VACUUM;"));
 		}
 	}
@@ -191,23 +403,7 @@ void HistoryManager::optionChanged(const QString &option)
 
 		if (enabled && !m_enabled)
 		{
-			QSqlDatabase database = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), QLatin1String("browsingHistory"));
-			database.setDatabaseName(SessionsManager::getProfilePath() + QLatin1String("/browsingHistory.sqlite"));
-			database.open();
-			database.exec(QStringLiteral("PRAGMA journal_mode = %1;").arg(SettingsManager::getValue(QLatin1String("Browser/SqliteJournalMode")).toString()));
-
-			if (!database.tables().contains(QLatin1String("visits")))
-			{
-				QFile file(QLatin1String(":/schemas/browsingHistory.sql"));
-				file.open(QIODevice::ReadOnly);
-
-				const QStringList queries = QString(file.readAll()).split(QLatin1String(";\n"));
-
-				for (int i = 0; i < queries.count(); ++i)
-				{
-					database.exec(queries.at(i));
-				}
-			}
+			openDatabase(SessionsManager::getProfilePath() + QLatin1String("/browsingHistory.sqlite"), SettingsManager::getValue(QLatin1String("Browser/SqliteJournalMode")).toString());
 		}
 		else if (!enabled && m_enabled)
 		{
@@ -222,6 +418,60 @@ void HistoryManager::optionChanged(const QString &option)
 	}
 }
 
+void HistoryManager::updateIcon(int request, const QByteArray &hash, const QByteArray &data)
+{
+	if (!m_iconRequests.contains(request))
+	{
+		return;
+	}
+
+	const qint64 entry = m_iconRequests.take(request);
+
+	if (!m_enabled || !m_storeFavicons)
+	{
+		return;
+	}
+
+	QSqlQuery selectQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	selectQuery.prepare(QLatin1String("SELECT \"id\" FROM \"icons\" WHERE \"hash\" = ?;"));
+	selectQuery.bindValue(0, QString(hash));
+	selectQuery.exec();
+
+	qint64 icon = -1;
+
+	if (selectQuery.first())
+	{
+		icon = selectQuery.record().field(QLatin1String("id")).value().toLongLong();
+	}
+	else
+	{
+		QSqlQuery insertQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+		insertQuery.prepare(QLatin1String("INSERT INTO \"icons\" (\"hash\", \"icon\") VALUES(?, ?);"));
+		insertQuery.bindValue(0, QString(hash));
+		insertQuery.bindValue(1, data);
+		insertQuery.exec();
+
+		if (insertQuery.lastInsertId().isNull())
+		{
+			return;
+		}
+
+		icon = insertQuery.lastInsertId().toLongLong();
+	}
+
+	QSqlQuery updateQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	updateQuery.prepare(QLatin1String("UPDATE \"visits\" SET \"icon\" = ? WHERE \"id\" = ? AND \"icon\" != ?;"));
+	updateQuery.bindValue(0, icon);
+	updateQuery.bindValue(1, entry);
+	updateQuery.bindValue(2, icon);
+	updateQuery.exec();
+
+	if (updateQuery.numRowsAffected() > 0)
+	{
+		emit entryUpdated(entry);
+	}
+}
+
 HistoryManager* HistoryManager::getInstance()
 {
 	return m_instance;
@@ -234,16 +484,13 @@ HistoryEntry HistoryManager::getEntry(const QSqlRecord &record)
 		return HistoryEntry();
 	}
 
-	QPixmap pixmap;
-	pixmap.loadFromData(record.field(QLatin1String("icon")).value().toByteArray());
-
 	HistoryEntry historyEntry;
 	historyEntry.url.setScheme(record.field(QLatin1String("scheme")).value().toString());
 	historyEntry.url.setHost(record.field(QLatin1String("host")).value().toString());
 	historyEntry.url.setPath(record.field(QLatin1String("path")).value().toString());
 	historyEntry.title = record.field(QLatin1String("title")).value().toString();
 	historyEntry.time = QDateTime::fromTime_t(record.field(QLatin1String("time")).value().toInt(), Qt::LocalTime);
-	historyEntry.icon = QIcon(pixmap);
+	historyEntry.icon = FaviconsManager::getIcon(record.field(QLatin1String("hash")).value().toByteArray(), record.field(QLatin1String("icon")).value().toByteArray());
 	historyEntry.identifier = record.field(QLatin1String("id")).value().toLongLong();
 	historyEntry.visits = record.field(QLatin1String("visits")).value().toInt();
 	historyEntry.typed = record.field(QLatin1String("typed")).value().toBool();
@@ -251,10 +498,24 @@ HistoryEntry HistoryManager::getEntry(const QSqlRecord &record)
 	return historyEntry;
 }
 
+HistoryEntry HistoryManager::getLocationEntry(const QSqlRecord &record)
+{
+	HistoryEntry historyEntry;
+	historyEntry.url.setScheme(record.field(QLatin1String("scheme")).value().toString());
+	historyEntry.url.setHost(record.field(QLatin1String("host")).value().toString());
+	historyEntry.url.setPath(record.field(QLatin1String("path")).value().toString());
+	historyEntry.title = record.field(QLatin1String("title")).value().toString();
+	historyEntry.time = QDateTime::fromTime_t(record.field(QLatin1String("time")).value().toInt(), Qt::LocalTime);
+	historyEntry.visits = record.field(QLatin1String("visits")).value().toInt();
+	historyEntry.typed = (record.field(QLatin1String("typed")).value().toInt() > 0);
+
+	return historyEntry;
+}
+
 HistoryEntry HistoryManager::getEntry(qint64 entry)
 {
 	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
-	query.prepare(QLatin1String("SELECT \"visits\".\"id\", \"visits\".\"title\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\", \"icons\".\"icon\", \"visits\".\"time\", \"visits\".\"typed\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" LEFT JOIN \"icons\" ON \"visits\".\"icon\" = \"icons\".\"id\" WHERE \"visits\".\"id\" = ?;"));
+	query.prepare(QLatin1String("SELECT \"visits\".\"id\", \"visits\".\"title\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\", \"icons\".\"hash\", \"icons\".\"icon\", \"visits\".\"time\", \"visits\".\"typed\", \"location_stats\".\"visits\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" LEFT JOIN \"icons\" ON \"visits\".\"icon\" = \"icons\".\"id\" LEFT JOIN \"location_stats\" ON \"visits\".\"location\" = \"location_stats\".\"location\" WHERE \"visits\".\"id\" = ?;"));
 	query.bindValue(0, entry);
 	query.exec();
 
@@ -270,7 +531,7 @@ QList<HistoryEntry> HistoryManager::getEntries(bool typed)
 {
 	QList<HistoryEntry> entries;
 	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
-	query.prepare(QLatin1String("SELECT \"visits\".\"id\", \"visits\".\"title\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\", \"icons\".\"icon\", \"visits\".\"time\", \"visits\".\"typed\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" LEFT JOIN \"icons\" ON \"visits\".\"icon\" = \"icons\".\"id\"") + (typed ? QLatin1String(" \"visits\".\"typed\" = 1") : QString()) + QLatin1String(" ORDER BY \"visits\".\"time\" DESC;"));
+	query.prepare(QLatin1String("SELECT \"visits\".\"id\", \"visits\".\"title\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\", \"icons\".\"hash\", \"icons\".\"icon\", \"visits\".\"time\", \"visits\".\"typed\", \"location_stats\".\"visits\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" LEFT JOIN \"icons\" ON \"visits\".\"icon\" = \"icons\".\"id\" LEFT JOIN \"location_stats\" ON \"visits\".\"location\" = \"location_stats\".\"location\"") + (typed ? QLatin1String(" \"visits\".\"typed\" = 1") : QString()) + QLatin1String(" ORDER BY \"visits\".\"time\" DESC;"));
 	query.exec();
 
 	while (query.next())
@@ -281,6 +542,193 @@ QList<HistoryEntry> HistoryManager::getEntries(bool typed)
 	return entries;
 }
 
+QList<HistoryEntry> HistoryManager::findEntries(const QString &text, int limit, int offset)
+{
+	QList<HistoryEntry> entries;
+	const QStringList words = text.split(QRegularExpression(QLatin1String("\\W+")), QString::SkipEmptyParts);
+
+	if (!m_enabled || words.isEmpty())
+	{
+		return entries;
+	}
+
+	if (m_hasSearchIndex)
+	{
+		QList<QPair<double, qint64> > ranking;
+		QSqlQuery searchQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+		searchQuery.prepare(QLatin1String("SELECT \"docid\", matchinfo(\"search\", 'pcx') AS \"matchinfo\" FROM \"search\" WHERE \"search\" MATCH ?;"));
+		searchQuery.bindValue(0, words.join(QLatin1String("* ")) + QLatin1Char('*'));
+		searchQuery.exec();
+
+		while (searchQuery.next())
+		{
+			ranking.append(qMakePair(getRank(searchQuery.record().field(QLatin1String("matchinfo")).value().toByteArray()), searchQuery.record().field(QLatin1String("docid")).value().toLongLong()));
+		}
+
+		qSort(ranking.begin(), ranking.end(), qGreater<QPair<double, qint64> >());
+
+		QStringList list;
+
+		for (int i = qMax(0, offset); i < ranking.count() && (limit < 0 || list.count() < limit); ++i)
+		{
+			list.append(QString::number(ranking.at(i).second));
+		}
+
+		if (list.isEmpty())
+		{
+			return entries;
+		}
+
+		QHash<qint64, HistoryEntry> matches;
+		QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+		query.prepare(QStringLiteral("SELECT \"visits\".\"id\", \"visits\".\"title\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\", \"icons\".\"hash\", \"icons\".\"icon\", \"visits\".\"time\", \"visits\".\"typed\", \"location_stats\".\"visits\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" LEFT JOIN \"icons\" ON \"visits\".\"icon\" = \"icons\".\"id\" LEFT JOIN \"location_stats\" ON \"visits\".\"location\" = \"location_stats\".\"location\" WHERE \"visits\".\"id\" IN(%1);").arg(list.join(QLatin1String(", "))));
+		query.exec();
+
+		while (query.next())
+		{
+			const HistoryEntry entry = getEntry(query.record());
+
+			matches[entry.identifier] = entry;
+		}
+
+		for (int i = 0; i < list.count(); ++i)
+		{
+			const qint64 identifier = list.at(i).toLongLong();
+
+			if (matches.contains(identifier))
+			{
+				entries.append(matches[identifier]);
+			}
+		}
+
+		return entries;
+	}
+
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QLatin1String("SELECT \"visits\".\"id\", \"visits\".\"title\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\", \"icons\".\"hash\", \"icons\".\"icon\", \"visits\".\"time\", \"visits\".\"typed\", \"location_stats\".\"visits\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" LEFT JOIN \"icons\" ON \"visits\".\"icon\" = \"icons\".\"id\" LEFT JOIN \"location_stats\" ON \"visits\".\"location\" = \"location_stats\".\"location\" WHERE (\"visits\".\"title\" || ' ' || \"hosts\".\"host\" || \"locations\".\"path\") LIKE ? ORDER BY \"visits\".\"typed\" DESC, \"visits\".\"time\" DESC LIMIT ? OFFSET ?;"));
+	query.bindValue(0, QLatin1Char('%') + text + QLatin1Char('%'));
+	query.bindValue(1, limit);
+	query.bindValue(2, offset);
+	query.exec();
+
+	while (query.next())
+	{
+		entries.append(getEntry(query.record()));
+	}
+
+	return entries;
+}
+
+QList<HistoryEntry> HistoryManager::getCompletions(const QString &text, int limit)
+{
+	QList<HistoryEntry> entries;
+
+	if (!m_enabled)
+	{
+		return entries;
+	}
+
+	QString prefix = text.trimmed().toLower();
+	prefix.remove(QRegularExpression(QLatin1String("^[a-z]+://")));
+
+	if (prefix.startsWith(QLatin1String("www.")))
+	{
+		prefix.remove(0, 4);
+	}
+
+	const int separator = prefix.indexOf(QLatin1Char('/'));
+	const QString hostPrefix = ((separator < 0) ? prefix : prefix.left(separator));
+
+	if (hostPrefix.isEmpty())
+	{
+		return entries;
+	}
+
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QLatin1String("SELECT \"location_stats\".\"title\", \"location_stats\".\"visits\", \"location_stats\".\"typed\", \"location_stats\".\"time\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\" FROM \"hosts\" INNER JOIN \"locations\" ON \"locations\".\"host\" = \"hosts\".\"id\" INNER JOIN \"location_stats\" ON \"location_stats\".\"location\" = \"locations\".\"id\" WHERE ((\"hosts\".\"host\" >= ? AND \"hosts\".\"host\" < ?) OR (\"hosts\".\"host\" >= ? AND \"hosts\".\"host\" < ?)) AND \"locations\".\"path\" LIKE ? ORDER BY \"location_stats\".\"frecency\" DESC LIMIT ?;"));
+	query.bindValue(0, hostPrefix);
+	query.bindValue(1, hostPrefix + QChar(0xFFFF));
+	query.bindValue(2, QLatin1String("www.") + hostPrefix);
+	query.bindValue(3, QLatin1String("www.") + hostPrefix + QChar(0xFFFF));
+	query.bindValue(4, ((separator < 0) ? QString() : prefix.mid(separator)) + QLatin1Char('%'));
+	query.bindValue(5, limit);
+	query.exec();
+
+	while (query.next())
+	{
+		entries.append(getLocationEntry(query.record()));
+	}
+
+	return entries;
+}
+
+QList<HistoryEntry> HistoryManager::getTopSites(int limit)
+{
+	QList<HistoryEntry> entries;
+
+	if (!m_enabled)
+	{
+		return entries;
+	}
+
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QLatin1String("SELECT \"location_stats\".\"title\", \"location_stats\".\"visits\", \"location_stats\".\"typed\", \"location_stats\".\"time\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\" FROM \"location_stats\" INNER JOIN \"locations\" ON \"location_stats\".\"location\" = \"locations\".\"id\" INNER JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" ORDER BY \"location_stats\".\"frecency\" DESC LIMIT ?;"));
+	query.bindValue(0, limit);
+	query.exec();
+
+	while (query.next())
+	{
+		entries.append(getLocationEntry(query.record()));
+	}
+
+	return entries;
+}
+
+QList<HistoryEntry> HistoryManager::getMostVisited(const QString &host, int limit)
+{
+	QList<HistoryEntry> entries;
+
+	if (!m_enabled)
+	{
+		return entries;
+	}
+
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QLatin1String("SELECT \"location_stats\".\"title\", \"location_stats\".\"visits\", \"location_stats\".\"typed\", \"location_stats\".\"time\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\" FROM \"hosts\" INNER JOIN \"locations\" ON \"locations\".\"host\" = \"hosts\".\"id\" INNER JOIN \"location_stats\" ON \"location_stats\".\"location\" = \"locations\".\"id\" WHERE \"hosts\".\"host\" = ? ORDER BY \"location_stats\".\"visits\" DESC, \"location_stats\".\"time\" DESC LIMIT ?;"));
+	query.bindValue(0, host.toLower());
+	query.bindValue(1, limit);
+	query.exec();
+
+	while (query.next())
+	{
+		entries.append(getLocationEntry(query.record()));
+	}
+
+	return entries;
+}
+
+QList<qint64> HistoryManager::getRecentEntries(int period)
+{
+	QList<qint64> entries;
+
+	if (!m_enabled)
+	{
+		return entries;
+	}
+
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QLatin1String("SELECT \"id\" FROM \"visits\" WHERE \"time\" >= ?;"));
+	query.bindValue(0, ((period > 0) ? (QDateTime::currentDateTime().toTime_t() - (period * 3600)) : 0));
+	query.exec();
+
+	while (query.next())
+	{
+		entries.append(query.record().field(QLatin1String("id")).value().toLongLong());
+	}
+
+	return entries;
+}
+
 qint64 HistoryManager::getRecord(const QLatin1String &table, const QVariantHash &values, bool canCreate)
 {
 	const QStringList keys = values.keys();
@@ -341,23 +789,96 @@ qint64 HistoryManager::getLocation(const QUrl &url, bool canCreate)
 	return getRecord(QLatin1String("locations"), locationsRecord, canCreate);
 }
 
-qint64 HistoryManager::getIcon(const QIcon &icon, bool canCreate)
+QList<qint64> HistoryManager::removeStatistics(const QString &condition)
 {
-	if (!m_storeFavicons)
+	QHash<qint64, int> visits;
+	QHash<qint64, int> typed;
+	QHash<qint64, double> scores;
+	const double base = getFrecencyBase(QDateTime::currentDateTime().toTime_t());
+	QSqlQuery selectQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	selectQuery.prepare(QStringLiteral("SELECT \"location\", \"time\", \"typed\" FROM \"visits\" WHERE %1;").arg(condition));
+	selectQuery.exec();
+
+	while (selectQuery.next())
+	{
+		const qint64 location = selectQuery.record().field(QLatin1String("location")).value().toLongLong();
+		const bool isTyped = selectQuery.record().field(QLatin1String("typed")).value().toBool();
+
+		visits[location] += 1;
+		typed[location] += (isTyped ? 1 : 0);
+		scores[location] += ((isTyped ? 2 : 1) * qExp(getFrecencyBase(selectQuery.record().field(QLatin1String("time")).value().toUInt()) - base));
+	}
+
+	const QList<qint64> locations = visits.keys();
+
+	for (int i = 0; i < locations.count(); ++i)
+	{
+		const qint64 location = locations.at(i);
+		QSqlQuery frecencyQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+		frecencyQuery.prepare(QLatin1String("SELECT \"frecency\" FROM \"location_stats\" WHERE \"location\" = ?;"));
+		frecencyQuery.bindValue(0, location);
+		frecencyQuery.exec();
+
+		if (!frecencyQuery.first())
+		{
+			continue;
+		}
+
+		const double score = (qExp(frecencyQuery.record().field(QLatin1String("frecency")).value().toDouble() - base) - scores[location]);
+		QSqlQuery updateQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+		updateQuery.prepare(QLatin1String("UPDATE \"location_stats\" SET \"visits\" = (\"visits\" - ?), \"typed\" = (\"typed\" - ?), \"frecency\" = ? WHERE \"location\" = ?;"));
+		updateQuery.bindValue(0, visits[location]);
+		updateQuery.bindValue(1, typed[location]);
+		updateQuery.bindValue(2, ((score > 0) ? (qLn(score) + base) : 0));
+		updateQuery.bindValue(3, location);
+		updateQuery.exec();
+	}
+
+	return locations;
+}
+
+double HistoryManager::getRank(const QByteArray &matchInfo)
+{
+	if (matchInfo.size() < static_cast<int>(2 * sizeof(quint32)))
 	{
 		return 0;
 	}
 
-	QByteArray data;
-	QBuffer buffer(&data);
-	buffer.open(QIODevice::WriteOnly);
+	const quint32 *data = reinterpret_cast<const quint32*>(matchInfo.constData());
+	const quint32 phrases = data[0];
+	const quint32 columns = data[1];
 
-	icon.pixmap(QSize(16, 16)).save(&buffer, "PNG");
+	if (matchInfo.size() < static_cast<int>((2 + (phrases * columns * 3)) * sizeof(quint32)))
+	{
+		return 0;
+	}
 
-	QVariantHash record;
-	record[QLatin1String("icon")] = data;
+	double rank = 0;
 
-	return getRecord(QLatin1String("icons"), record, canCreate);
+	for (quint32 i = 0; i < (phrases * columns); ++i)
+	{
+		const quint32 rowHits = data[2 + (i * 3)];
+		const quint32 allHits = data[3 + (i * 3)];
+
+		if (rowHits > 0 && allHits > 0)
+		{
+			rank += (static_cast<double>(rowHits) / allHits);
+		}
+	}
+
+	return rank;
+}
+
+double HistoryManager::addFrecency(double frecency, bool typed, uint time)
+{
+	const double base = getFrecencyBase(time);
+
+	return (qLn(qExp(frecency - base) + (typed ? 2 : 1)) + base);
+}
+
+double HistoryManager::getFrecencyBase(uint time)
+{
+	return (time / 2592000.0);
 }
 
 qint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QIcon &icon, bool typed)
@@ -368,18 +889,33 @@ qint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QIc
 	}
 
 	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
-	query.prepare(QLatin1String("INSERT INTO \"visits\" (\"location\", \"icon\", \"title\", \"time\", \"typed\") VALUES(?, ?, ?, ?, ?);"));
-	query.bindValue(0, getLocation(url));
-	query.bindValue(1, getIcon(icon));
-	query.bindValue(2, title);
-	query.bindValue(3, QDateTime::currentDateTime().toTime_t());
-	query.bindValue(4, typed);
+	const qint64 location = getLocation(url);
+	const uint time = QDateTime::currentDateTime().toTime_t();
+	query.prepare(QLatin1String("INSERT INTO \"visits\" (\"location\", \"icon\", \"title\", \"time\", \"typed\") VALUES(?, 0, ?, ?, ?);"));
+	query.bindValue(0, location);
+	query.bindValue(1, title);
+	query.bindValue(2, time);
+	query.bindValue(3, typed);
 	query.exec();
 
 	if (!query.lastInsertId().isNull())
 	{
 		const qint64 entry = query.lastInsertId().toLongLong();
 
+		updateStatistics(location, title, typed, time);
+
+		if (m_hasSearchIndex)
+		{
+			QSqlQuery searchQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+			searchQuery.prepare(QLatin1String("INSERT INTO \"search\" (\"docid\", \"title\", \"url\") VALUES(?, ?, ?);"));
+			searchQuery.bindValue(0, entry);
+			searchQuery.bindValue(1, title);
+			searchQuery.bindValue(2, url.toString(QUrl::RemovePassword));
+			searchQuery.exec();
+		}
+
+		scheduleIcon(entry, icon);
+
 		emit m_instance->entryAdded(entry);
 
 		return entry;
@@ -407,18 +943,56 @@ bool HistoryManager::updateEntry(qint64 entry, const QUrl &url, const QString &t
 		return false;
 	}
 
+	QSqlQuery selectQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	selectQuery.prepare(QLatin1String("SELECT \"location\", \"time\", \"typed\" FROM \"visits\" WHERE \"id\" = ?;"));
+	selectQuery.bindValue(0, entry);
+	selectQuery.exec();
+
+	if (!selectQuery.first())
+	{
+		return false;
+	}
+
+	const qint64 location = getLocation(url);
+	const bool isMoved = (location != selectQuery.record().field(QLatin1String("location")).value().toLongLong());
+	const QList<qint64> locations = (isMoved ? removeStatistics(QStringLiteral("\"id\" = %1").arg(entry)) : QList<qint64>());
 	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
-	query.prepare(QLatin1String("UPDATE \"visits\" SET \"location\" = ?, \"icon\" = ?, \"title\" = ? WHERE \"id\" = ?;"));
-	query.bindValue(0, getLocation(url));
-	query.bindValue(1, getIcon(icon));
-	query.bindValue(2, title);
-	query.bindValue(3, entry);
+	query.prepare(QLatin1String("UPDATE \"visits\" SET \"location\" = ?, \"title\" = ? WHERE \"id\" = ?;"));
+	query.bindValue(0, location);
+	query.bindValue(1, title);
+	query.bindValue(2, entry);
 	query.exec();
 
 	const bool success = (query.numRowsAffected() > 0);
 
 	if (success)
 	{
+		if (isMoved)
+		{
+			updateStatistics(location, title, selectQuery.record().field(QLatin1String("typed")).value().toBool(), selectQuery.record().field(QLatin1String("time")).value().toUInt());
+			cleanupStatistics(locations);
+		}
+		else
+		{
+			QSqlQuery statisticsQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+			statisticsQuery.prepare(QLatin1String("UPDATE \"location_stats\" SET \"title\" = ? WHERE \"location\" = ?;"));
+			statisticsQuery.bindValue(0, title);
+			statisticsQuery.bindValue(1, location);
+			statisticsQuery.exec();
+		}
+
+		if (m_hasSearchIndex)
+		{
+			QSqlQuery searchQuery(QSqlDatabase::database(QLatin1String("browsingHistory")));
+			searchQuery.prepare(QLatin1String("UPDATE \"search\" SET \"title\" = ?, \"url\" = ? WHERE \"docid\" = ?;"));
+			searchQuery.bindValue(0, title);
+			searchQuery.bindValue(1, url.toString(QUrl::RemovePassword));
+			searchQuery.bindValue(2, entry);
+			searchQuery.exec();
+		}
+
+		scheduleIcon(entry, icon);
+
 		m_instance->scheduleCleanup();
 
 		emit m_instance->entryUpdated(entry);
@@ -429,6 +1003,10 @@ bool HistoryManager::updateEntry(qint64 entry, const QUrl &url, const QString &t
 
 bool HistoryManager::removeEntry(qint64 entry)
 {
+	const QList<qint64> locations = removeStatistics(QStringLiteral("\"id\" = %1").arg(entry));
+
+	removeSearchEntries(QStringLiteral("\"id\" = %1").arg(entry));
+
 	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
 	query.prepare(QLatin1String("DELETE FROM \"visits\" WHERE \"id\" = ?;"));
 	query.bindValue(0, entry);
@@ -438,6 +1016,8 @@ bool HistoryManager::removeEntry(qint64 entry)
 
 	if (success)
 	{
+		cleanupStatistics(locations);
+
 		m_instance->scheduleCleanup();
 
 		emit m_instance->entryRemoved(entry);
@@ -463,12 +1043,23 @@ bool HistoryManager::removeEntries(const QList<qint64> &entries)
 		return false;
 	}
 
-	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	QSqlDatabase database = QSqlDatabase::database(QLatin1String("browsingHistory"));
+	database.transaction();
+
+	const QList<qint64> locations = removeStatistics(QStringLiteral("\"id\" IN(%1)").arg(list.join(QLatin1String(", "))));
+
+	removeSearchEntries(QStringLiteral("\"id\" IN(%1)").arg(list.join(QLatin1String(", "))));
+
+	QSqlQuery query(database);
 	query.prepare(QStringLiteral("DELETE FROM \"visits\" WHERE \"id\" IN(%1);").arg(list.join(QLatin1String(", "))));
 	query.exec();
 
 	const bool success = (query.numRowsAffected() > 0);
 
+	cleanupStatistics(locations);
+
+	database.commit();
+
 	if (success)
 	{
 		m_instance->scheduleCleanup();
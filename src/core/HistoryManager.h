@@ -52,6 +52,11 @@ public:
 	static HistoryManager* getInstance();
 	static HistoryEntry getEntry(qint64 entry);
 	static QList<HistoryEntry> getEntries(bool typed = false);
+	static QList<HistoryEntry> findEntries(const QString &text, int limit = 50, int offset = 0);
+	static QList<HistoryEntry> getCompletions(const QString &text, int limit = 10);
+	static QList<HistoryEntry> getTopSites(int limit = 10);
+	static QList<HistoryEntry> getMostVisited(const QString &host, int limit = 10);
+	static QList<qint64> getRecentEntries(int period);
 	static qint64 addEntry(const QUrl &url, const QString &title, const QIcon &icon, bool typed = false);
 	static bool hasUrl(const QUrl &url);
 	static bool updateEntry(qint64 entry, const QUrl &url, const QString &title, const QIcon &icon);
@@ -63,22 +68,35 @@ protected:
 
 	void timerEvent(QTimerEvent *event);
 	void scheduleCleanup();
+	void cleanup();
 	void removeOldEntries(const QDateTime &date = QDateTime());
+	static void openDatabase(const QString &path, const QString &journalMode);
+	static void scheduleIcon(qint64 entry, const QIcon &icon);
+	static void updateStatistics(qint64 location, const QString &title, bool typed, uint time);
+	static void cleanupStatistics(const QList<qint64> &locations);
+	static void removeSearchEntries(const QString &condition);
 	static HistoryEntry getEntry(const QSqlRecord &record);
+	static HistoryEntry getLocationEntry(const QSqlRecord &record);
+	static QList<qint64> removeStatistics(const QString &condition);
 	static qint64 getRecord(const QLatin1String &table, const QVariantHash &values, bool canCreate = true);
 	static qint64 getLocation(const QUrl &url, bool canCreate = true);
-	static qint64 getIcon(const QIcon &icon, bool canCreate = true);
+	static double getRank(const QByteArray &matchInfo);
+	static double addFrecency(double frecency, bool typed, uint time);
+	static double getFrecencyBase(uint time);
 
 protected slots:
 	void optionChanged(const QString &option);
+	void updateIcon(int request, const QByteArray &hash, const QByteArray &data);
 
 private:
+	QHash<int, qint64> m_iconRequests;
 	int m_cleanupTimer;
 	int m_dayTimer;
 
 	static HistoryManager *m_instance;
 	static bool m_enabled;
 	static bool m_storeFavicons;
+	static bool m_hasSearchIndex;
 
 signals:
 	void cleared();
@@ -86,6 +104,8 @@ signals:
 	void entryUpdated(qint64 entry);
 	void entryRemoved(qint64 entry);
 	void dayChanged();
+
+friend class HistoryBenchmark;
 };
 
 }
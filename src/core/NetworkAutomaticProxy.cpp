@@ -29,35 +29,29 @@
 namespace Otter
 {
 
+QHash<QString, QPair<QHostAddress, QDateTime> > NetworkAutomaticProxy::m_hosts;
+QPair<QString, QDateTime> NetworkAutomaticProxy::m_ipAddress;
 QStringList NetworkAutomaticProxy::m_months = QStringList() << QLatin1String("jan") << QLatin1String("feb") << QLatin1String("mar") << QLatin1String("apr") << QLatin1String("may") << QLatin1String("jun") << QLatin1String("jul") << QLatin1String("aug") << QLatin1String("sep") << QLatin1String("oct") << QLatin1String("nov") << QLatin1String("dec");
 QStringList NetworkAutomaticProxy::m_days = QStringList() << QLatin1String("mon") << QLatin1String("tue") << QLatin1String("wed") << QLatin1String("thu") << QLatin1String("fri") << QLatin1String("sat") << QLatin1String("sun");
 
-NetworkAutomaticProxy::NetworkAutomaticProxy()
+NetworkAutomaticProxy::NetworkAutomaticProxy(QObject *parent) : QObject(parent),
+	m_engine(NULL)
 {
 	m_proxies.insert(QLatin1String("ERROR"), QList<QNetworkProxy>() << QNetworkProxy(QNetworkProxy::DefaultProxy));
 	m_proxies.insert(QLatin1String("DIRECT"), QList<QNetworkProxy>() << QNetworkProxy(QNetworkProxy::NoProxy));
-
-	m_engine.globalObject().setProperty(QLatin1String("alert"), m_engine.newFunction(alert));
-	m_engine.globalObject().setProperty(QLatin1String("shExpMatch"), m_engine.newFunction(shExpMatch));
-	m_engine.globalObject().setProperty(QLatin1String("dnsDomainIs"), m_engine.newFunction(dnsDomainIs));
-	m_engine.globalObject().setProperty(QLatin1String("isInNet"), m_engine.newFunction(isInNet));
-	m_engine.globalObject().setProperty(QLatin1String("myIpAddress"), m_engine.newFunction(myIpAddress));
-	m_engine.globalObject().setProperty(QLatin1String("dnsResolve"), m_engine.newFunction(dnsResolve));
-	m_engine.globalObject().setProperty(QLatin1String("isPlainHostName"), m_engine.newFunction(isPlainHostName));
-	m_engine.globalObject().setProperty(QLatin1String("isResolvable"), m_engine.newFunction(isResolvable));
-	m_engine.globalObject().setProperty(QLatin1String("localHostOrDomainIs"), m_engine.newFunction(localHostOrDomainIs));
-	m_engine.globalObject().setProperty(QLatin1String("dnsDomainLevels"), m_engine.newFunction(dnsDomainLevels));
-	m_engine.globalObject().setProperty(QLatin1String("weekdayRange"), m_engine.newFunction(weekdayRange));
-	m_engine.globalObject().setProperty(QLatin1String("dateRange"), m_engine.newFunction(dateRange));
-	m_engine.globalObject().setProperty(QLatin1String("timeRange"), m_engine.newFunction(timeRange));
 }
 
 QList<QNetworkProxy> NetworkAutomaticProxy::getProxy(const QString &url, const QString &host)
 {
+	if (!m_engine)
+	{
+		return m_proxies[QLatin1String("ERROR")];
+	}
+
 	QScriptValueList arguments;
-	arguments << m_engine.toScriptValue(url) << m_engine.toScriptValue(host);
+	arguments << m_engine->toScriptValue(url) << m_engine->toScriptValue(host);
 
-	const QScriptValue result = m_findProxy.call(m_engine.globalObject(), arguments);
+	const QScriptValue result = m_findProxy.call(m_engine->globalObject(), arguments);
 
 	if (result.isError())
 	{
@@ -171,13 +165,22 @@ QScriptValue NetworkAutomaticProxy::myIpAddress(QScriptContext *context, QScript
 		return context->throwError(QLatin1String("Function myIpAddress does not take any arguments!"));
 	}
 
+	if (m_ipAddress.second.isValid() && m_ipAddress.second > QDateTime::currentDateTimeUtc())
+	{
+		return (m_ipAddress.first.isEmpty() ? engine->undefinedValue() : QScriptValue(m_ipAddress.first));
+	}
+
 	const QList<QHostAddress> addresses = QNetworkInterface::allAddresses();
 
+	m_ipAddress = qMakePair(QString(), QDateTime::currentDateTimeUtc().addSecs(60));
+
 	for (int i = 0; i < addresses.count(); ++i)
 	{
 		if (!addresses.at(i).isNull() && addresses.at(i) != QHostAddress::LocalHost && addresses.at(i) != QHostAddress::LocalHostIPv6 && addresses.at(i) != QHostAddress::Null && addresses.at(i) != QHostAddress::Broadcast && addresses.at(i) != QHostAddress::Any && addresses.at(i) != QHostAddress::AnyIPv6)
 		{
-			return addresses.at(i).toString();
+			m_ipAddress.first = addresses.at(i).toString();
+
+			return m_ipAddress.first;
 		}
 	}
 
@@ -191,11 +194,11 @@ QScriptValue NetworkAutomaticProxy::dnsResolve(QScriptContext *context, QScriptE
 		return context->throwError(QLatin1String("Function dnsResolve takes only one argument!"));
 	}
 
-	const QHostInfo host = QHostInfo::fromName(context->argument(0).toString());
+	const QHostAddress address = resolveHost(context->argument(0).toString());
 
-	if (host.error() == QHostInfo::NoError)
+	if (!address.isNull())
 	{
-		return host.addresses().first().toString();
+		return address.toString();
 	}
 
 	return engine->undefinedValue();
@@ -222,7 +225,7 @@ QScriptValue NetworkAutomaticProxy::isResolvable(QScriptContext *context, QScrip
 		return context->throwError(QLatin1String("Function isResolvable takes only one argument!"));
 	}
 
-	return (QHostInfo::fromName(context->argument(0).toString()).error() == QHostInfo::NoError);
+	return !resolveHost(context->argument(0).toString()).isNull();
 }
 
 QScriptValue NetworkAutomaticProxy::localHostOrDomainIs(QScriptContext *context, QScriptEngine *engine)
@@ -427,6 +430,29 @@ QScriptValue NetworkAutomaticProxy::timeRange(QScriptContext *context, QScriptEn
 	return false;
 }
 
+QHostAddress NetworkAutomaticProxy::resolveHost(const QString &host)
+{
+	const QString key = host.toLower();
+	const QDateTime currentDateTime = QDateTime::currentDateTimeUtc();
+
+	if (m_hosts.contains(key) && m_hosts[key].second > currentDateTime)
+	{
+		return m_hosts[key].first;
+	}
+
+	const QHostInfo information = QHostInfo::fromName(host);
+	const QHostAddress address = ((information.error() == QHostInfo::NoError && !information.addresses().isEmpty()) ? information.addresses().first() : QHostAddress());
+
+	if (m_hosts.count() > 1000)
+	{
+		m_hosts.clear();
+	}
+
+	m_hosts[key] = qMakePair(address, currentDateTime.addSecs(address.isNull() ? 60 : 300));
+
+	return address;
+}
+
 QDateTime NetworkAutomaticProxy::getDateTime(QScriptContext *context, int *numberOfArguments)
 {
 	if (context->argument(context->argumentCount() - 1).toString().toLower() == QLatin1String("gmt"))
@@ -449,12 +475,34 @@ QDateTime NetworkAutomaticProxy::getDateTime(QScriptContext *context, int *numbe
 
 bool NetworkAutomaticProxy::setup(const QString &script)
 {
-	if (!m_engine.canEvaluate(script) || m_engine.evaluate(script).isError())
+	if (m_engine)
+	{
+		m_engine->deleteLater();
+	}
+
+	m_engine = new QScriptEngine(this);
+	m_engine->globalObject().setProperty(QLatin1String("alert"), m_engine->newFunction(alert));
+	m_engine->globalObject().setProperty(QLatin1String("shExpMatch"), m_engine->newFunction(shExpMatch));
+	m_engine->globalObject().setProperty(QLatin1String("dnsDomainIs"), m_engine->newFunction(dnsDomainIs));
+	m_engine->globalObject().setProperty(QLatin1String("isInNet"), m_engine->newFunction(isInNet));
+	m_engine->globalObject().setProperty(QLatin1String("myIpAddress"), m_engine->newFunction(myIpAddress));
+	m_engine->globalObject().setProperty(QLatin1String("dnsResolve"), m_engine->newFunction(dnsResolve));
+	m_engine->globalObject().setProperty(QLatin1String("isPlainHostName"), m_engine->newFunction(isPlainHostName));
+	m_engine->globalObject().setProperty(QLatin1String("isResolvable"), m_engine->newFunction(isResolvable));
+	m_engine->globalObject().setProperty(QLatin1String("localHostOrDomainIs"), m_engine->newFunction(localHostOrDomainIs));
+	m_engine->globalObject().setProperty(QLatin1String("dnsDomainLevels"), m_engine->newFunction(dnsDomainLevels));
+	m_engine->globalObject().setProperty(QLatin1String("weekdayRange"), m_engine->newFunction(weekdayRange));
+	m_engine->globalObject().setProperty(QLatin1String("dateRange"), m_engine->newFunction(dateRange));
+	m_engine->globalObject().setProperty(QLatin1String("timeRange"), m_engine->newFunction(timeRange));
+
+	m_findProxy = QScriptValue();
+
+	if (!m_engine->canEvaluate(script) || m_engine->evaluate(script).isError())
 	{
 		return false;
 	}
 
-	m_findProxy = m_engine.globalObject().property(QLatin1String("FindProxyForURL"));
+	m_findProxy = m_engine->globalObject().property(QLatin1String("FindProxyForURL"));
 
 	return m_findProxy.isFunction();
 }
@@ -21,6 +21,8 @@
 #ifndef OTTER_NETWORKAUTOMATICPROXY_H
 #define OTTER_NETWORKAUTOMATICPROXY_H
 
+#include <QtCore/QDateTime>
+#include <QtNetwork/QHostAddress>
 #include <QtNetwork/QNetworkProxy>
 #include <QtScript/QScriptEngine>
 #include <QtScript/QScriptValue>
@@ -28,11 +30,14 @@
 namespace Otter
 {
 
-class NetworkAutomaticProxy
+class NetworkAutomaticProxy : public QObject
 {
+	Q_OBJECT
+
 public:
-	explicit NetworkAutomaticProxy();
+	explicit NetworkAutomaticProxy(QObject *parent = NULL);
 
+public slots:
 	QList<QNetworkProxy> getProxy(const QString &url, const QString &host);
 	bool setup(const QString &script);
 
@@ -50,14 +55,17 @@ protected:
 	static QScriptValue weekdayRange(QScriptContext *context, QScriptEngine *engine);
 	static QScriptValue dateRange(QScriptContext *context, QScriptEngine *engine);
 	static QScriptValue timeRange(QScriptContext *context, QScriptEngine *engine);
+	static QHostAddress resolveHost(const QString &host);
 	static QDateTime getDateTime(QScriptContext *context, int *numberOfArguments = NULL);
 	static bool compareRange(const QVariant &valueOne, const QVariant &valueTwo, const QVariant &actualValue);
 
 private:
-	QScriptEngine m_engine;
+	QScriptEngine *m_engine;
 	QScriptValue m_findProxy;
 	QHash<QString, QList<QNetworkProxy> > m_proxies;
 
+	static QHash<QString, QPair<QHostAddress, QDateTime> > m_hosts;
+	static QPair<QString, QDateTime> m_ipAddress;
 	static QStringList m_months;
 	static QStringList m_days;
 };
@@ -18,17 +18,41 @@
 **************************************************************************/
 
 #include "NetworkCache.h"
+#include "PageSnapshotsManager.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
-#include <QtCore/QDateTime>
+#include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMap>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimerEvent>
+#include <QtCore/qmath.h>
 
 namespace Otter
 {
 
-NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
+const QNetworkRequest::Attribute NetworkCache::CompressedAttribute = static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 1);
+
+NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent),
+	m_journal(NULL),
+	m_memoryMetaData(1000),
+	m_typeSizes(5, 0),
+	m_typeLimits(5, 0),
+	m_totalSize(0),
+	m_objectSizeLimit(0),
+	m_memoryHits(0),
+	m_memoryMisses(0),
+	m_evictionTimer(0),
+	m_journalSize(0),
+	m_compressResources(SettingsManager::getValue(QLatin1String("Cache/CompressResources")).toBool()),
+	m_isIndexLoaded(false)
 {
+	m_memoryData.setMaxCost(SettingsManager::getValue(QLatin1String("Cache/MemoryCacheLimit")).toInt() * 1024);
+
 	const QString cachePath = SessionsManager::getCachePath();
 
 	if (!cachePath.isEmpty())
@@ -39,11 +63,47 @@ NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
 		setMaximumCacheSize(SettingsManager::getValue(QLatin1String("Cache/DiskCacheLimit")).toInt() * 1024);
 	}
 
+	updateLimits();
+
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
 }
 
+NetworkCache::~NetworkCache()
+{
+	saveIndex();
+}
+
+void NetworkCache::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_evictionTimer)
+	{
+		return;
+	}
+
+	if (m_evictionQueue.isEmpty())
+	{
+		prepareEviction();
+
+		if (m_evictionQueue.isEmpty())
+		{
+			killTimer(m_evictionTimer);
+
+			m_evictionTimer = 0;
+
+			return;
+		}
+	}
+
+	for (int i = 0; (i < 50 && !m_evictionQueue.isEmpty()); ++i)
+	{
+		remove(m_evictionQueue.takeFirst());
+	}
+}
+
 void NetworkCache::clearCache(int period)
 {
+	PageSnapshotsManager::clearSnapshots(period);
+
 	if (period <= 0)
 	{
 		clear();
@@ -53,63 +113,264 @@ void NetworkCache::clearCache(int period)
 		return;
 	}
 
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories = cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+	const QList<QUrl> entries = getEntries(period);
 
-	for (int i = 0; i < directories.count(); ++i)
+	for (int i = 0; i < entries.count(); ++i)
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories = cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+		remove(entries.at(i));
+	}
+}
 
-		for (int j = 0; j < subDirectories.count(); ++j)
-		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files = cacheFilesDirectory.entryList(QDir::Files);
+void NetworkCache::clear()
+{
+	loadIndex();
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QNetworkCacheMetaData metaData = fileMetaData(cacheFilesDirectory.absoluteFilePath(files.at(k)));
+	QHash<QUrl, NetworkCacheEntry>::const_iterator iterator;
 
-				if (metaData.isValid() && metaData.lastModified().isValid() && metaData.lastModified().secsTo(QDateTime::currentDateTime()) > (period * 3600))
-				{
-					remove(metaData.url());
-				}
-			}
-		}
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		QNetworkDiskCache::remove(iterator.key());
 	}
+
+	m_entries.clear();
+	m_evictionQueue.clear();
+	m_typeSizes.fill(0);
+	m_totalSize = 0;
+	m_memoryData.clear();
+	m_memoryMetaData.clear();
+
+	saveIndex();
 }
 
 void NetworkCache::insert(QIODevice *device)
 {
+	if (m_compressedDevices.contains(device))
+	{
+		m_compressedDevices.remove(device);
+
+		const QNetworkCacheMetaData metaData = m_devices.take(device);
+		QBuffer *buffer = qobject_cast<QBuffer*>(device);
+		QIODevice *cacheDevice = (buffer ? QNetworkDiskCache::prepare(metaData) : NULL);
+
+		if (cacheDevice)
+		{
+			cacheDevice->write(qCompress(buffer->data(), 1));
+
+			m_devices[cacheDevice] = metaData;
+		}
+
+		device->deleteLater();
+
+		if (!cacheDevice)
+		{
+			return;
+		}
+
+		device = cacheDevice;
+	}
+
+	const qint64 size = device->size();
+
 	QNetworkDiskCache::insert(device);
 
 	if (m_devices.contains(device))
 	{
-		emit entryAdded(m_devices[device]);
+		const QNetworkCacheMetaData metaData = m_devices.take(device);
+
+		m_memoryData.remove(metaData.url());
+		m_memoryMetaData.remove(metaData.url());
+
+		loadIndex();
+
+		NetworkCacheEntry entry;
+		entry.url = metaData.url();
+		entry.path = m_entries.value(entry.url).path;
+		entry.lastAccessed = QDateTime::currentDateTime();
+		entry.size = size;
+
+		if (m_objectSizeLimit > 0 && entry.size > m_objectSizeLimit)
+		{
+			remove(entry.url);
+
+			return;
+		}
+
+		updateEntry(entry, metaData);
+		addIndexEntry(entry);
+		writeJournal(entry);
+
+		emit entryAdded(entry.url);
 
-		m_devices.remove(device);
+		const ResourceType type = getResourceType(entry.contentType);
+
+		if (m_totalSize > maximumCacheSize() || (m_typeLimits[type] > 0 && m_typeSizes[type] > m_typeLimits[type]))
+		{
+			scheduleEviction();
+		}
 	}
 }
 
-QIODevice* NetworkCache::prepare(const QNetworkCacheMetaData &metaData)
+void NetworkCache::updateMetaData(const QNetworkCacheMetaData &metaData)
 {
-	QIODevice *device = QNetworkDiskCache::prepare(metaData);
+	QNetworkDiskCache::updateMetaData(metaData);
 
-	if (device)
+	m_memoryMetaData.remove(metaData.url());
+
+	if (m_isIndexLoaded && m_entries.contains(metaData.url()))
 	{
-		m_devices[device] = metaData.url();
+		NetworkCacheEntry entry = m_entries.value(metaData.url());
+
+		updateEntry(entry, metaData);
+		addIndexEntry(entry);
+		writeJournal(entry);
 	}
+}
 
-	return device;
+void NetworkCache::loadIndex()
+{
+	if (m_isIndexLoaded || cacheDirectory().isEmpty())
+	{
+		return;
+	}
+
+	m_isIndexLoaded = true;
+
+	QFile file(getIndexPath());
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		rebuildIndex();
+
+		return;
+	}
+
+	QDataStream stream(&file);
+	quint32 version;
+	quint32 amount;
+
+	stream >> version;
+
+	if (version != 2)
+	{
+		file.close();
+
+		rebuildIndex();
+
+		return;
+	}
+
+	stream >> amount;
+
+	for (quint32 i = 0; i < amount; ++i)
+	{
+		NetworkCacheEntry entry;
+
+		stream >> entry.url >> entry.path >> entry.contentType >> entry.lastModified >> entry.expirationDate >> entry.lastAccessed >> entry.size >> entry.accesses;
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			file.close();
+
+			rebuildIndex();
+
+			return;
+		}
+
+		addIndexEntry(entry);
+	}
+
+	file.close();
+
+	QFile journal(getJournalPath());
+
+	if (!journal.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream journalStream(&journal);
+
+	while (!journalStream.atEnd())
+	{
+		NetworkCacheEntry entry;
+		bool isRemoved;
+
+		journalStream >> isRemoved >> entry.url;
+
+		if (!isRemoved)
+		{
+			journalStream >> entry.path >> entry.contentType >> entry.lastModified >> entry.expirationDate >> entry.lastAccessed >> entry.size >> entry.accesses;
+		}
+
+		if (journalStream.status() != QDataStream::Ok)
+		{
+			break;
+		}
+
+		if (isRemoved)
+		{
+			removeIndexEntry(entry.url);
+		}
+		else
+		{
+			addIndexEntry(entry);
+		}
+	}
+
+	journal.close();
+
+	saveIndex();
 }
 
-QString NetworkCache::getPathForUrl(const QUrl &url)
+void NetworkCache::saveIndex()
 {
-	if (!url.isValid() || !metaData(url).isValid())
+	if (!m_isIndexLoaded || cacheDirectory().isEmpty())
 	{
-		return QString();
+		return;
+	}
+
+	QSaveFile file(getIndexPath());
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream << quint32(2) << quint32(m_entries.count());
+
+	QHash<QUrl, NetworkCacheEntry>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		const NetworkCacheEntry &entry = iterator.value();
+
+		stream << entry.url << entry.path << entry.contentType << entry.lastModified << entry.expirationDate << entry.lastAccessed << entry.size << entry.accesses;
+	}
+
+	if (!file.commit())
+	{
+		return;
 	}
 
+	if (m_journal)
+	{
+		m_journal->close();
+		delete m_journal;
+		m_journal = NULL;
+	}
+
+	m_journalSize = 0;
+
+	QFile::remove(getJournalPath());
+}
+
+void NetworkCache::rebuildIndex()
+{
+	m_entries.clear();
+	m_typeSizes.fill(0);
+	m_totalSize = 0;
+
 	const QDir cacheMainDirectory(cacheDirectory());
 	const QStringList directories = cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
 
@@ -121,62 +382,493 @@ QString NetworkCache::getPathForUrl(const QUrl &url)
 		for (int j = 0; j < subDirectories.count(); ++j)
 		{
 			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files = cacheFilesDirectory.entryList(QDir::Files);
+			const QFileInfoList files = cacheFilesDirectory.entryInfoList(QDir::Files);
 
 			for (int k = 0; k < files.count(); ++k)
 			{
-				const QString cacheFilePath = cacheFilesDirectory.absoluteFilePath(files.at(k));
-				const QNetworkCacheMetaData metaData = fileMetaData(cacheFilePath);
+				const QNetworkCacheMetaData metaData = fileMetaData(files.at(k).absoluteFilePath());
 
-				if (metaData.isValid() && url == metaData.url())
+				if (!metaData.isValid() || !metaData.url().isValid())
 				{
-					return cacheFilePath;
+					continue;
 				}
+
+				NetworkCacheEntry entry;
+				entry.url = metaData.url();
+				entry.path = cacheMainDirectory.relativeFilePath(files.at(k).absoluteFilePath());
+				entry.lastAccessed = files.at(k).lastRead();
+				entry.size = files.at(k).size();
+
+				updateEntry(entry, metaData);
+				addIndexEntry(entry);
 			}
 		}
 	}
 
-	return QString();
+	saveIndex();
 }
 
-QList<QUrl> NetworkCache::getEntries() const
+void NetworkCache::addIndexEntry(const NetworkCacheEntry &entry)
 {
-	QList<QUrl> entries;
+	removeIndexEntry(entry.url);
 
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories = cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+	const ResourceType type = getResourceType(entry.contentType);
 
-	for (int i = 0; i < directories.count(); ++i)
+	m_entries[entry.url] = entry;
+	m_typeSizes[type] += entry.size;
+	m_totalSize += entry.size;
+}
+
+void NetworkCache::removeIndexEntry(const QUrl &url)
+{
+	if (!m_entries.contains(url))
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories = cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+		return;
+	}
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+	const NetworkCacheEntry entry = m_entries.take(url);
+	const ResourceType type = getResourceType(entry.contentType);
+
+	m_typeSizes[type] -= entry.size;
+	m_totalSize -= entry.size;
+}
+
+void NetworkCache::updateEntry(NetworkCacheEntry &entry, const QNetworkCacheMetaData &metaData)
+{
+	entry.lastModified = metaData.lastModified();
+	entry.expirationDate = metaData.expirationDate();
+	entry.contentType = QString(getHeader(metaData, QByteArray("content-type")));
+}
+
+void NetworkCache::writeJournal(const NetworkCacheEntry &entry, bool isRemoved)
+{
+	if (cacheDirectory().isEmpty())
+	{
+		return;
+	}
+
+	if (!m_journal)
+	{
+		m_journal = new QFile(getJournalPath(), this);
+
+		if (!m_journal->open(QIODevice::WriteOnly | QIODevice::Append))
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files = cacheFilesDirectory.entryList(QDir::Files);
+			delete m_journal;
+			m_journal = NULL;
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QNetworkCacheMetaData metaData = fileMetaData(cacheFilesDirectory.absoluteFilePath(files.at(k)));
+			return;
+		}
+	}
 
-				if (metaData.url().isValid())
-				{
-					entries.append(metaData.url());
-				}
-			}
+	QDataStream stream(m_journal);
+	stream << isRemoved << entry.url;
+
+	if (!isRemoved)
+	{
+		stream << entry.path << entry.contentType << entry.lastModified << entry.expirationDate << entry.lastAccessed << entry.size << entry.accesses;
+	}
+
+	m_journal->flush();
+
+	++m_journalSize;
+
+	if (m_journalSize > 1000 && m_isIndexLoaded)
+	{
+		saveIndex();
+	}
+}
+
+void NetworkCache::updateLimits()
+{
+	const qint64 limit = maximumCacheSize();
+
+	m_typeLimits[DocumentResource] = (limit * SettingsManager::getValue(QLatin1String("Cache/DocumentsBudget")).toInt() / 100);
+	m_typeLimits[ScriptResource] = (limit * SettingsManager::getValue(QLatin1String("Cache/ScriptsBudget")).toInt() / 100);
+	m_typeLimits[ImageResource] = (limit * SettingsManager::getValue(QLatin1String("Cache/ImagesBudget")).toInt() / 100);
+	m_typeLimits[MediaResource] = (limit * SettingsManager::getValue(QLatin1String("Cache/MediaBudget")).toInt() / 100);
+	m_objectSizeLimit = (SettingsManager::getValue(QLatin1String("Cache/MaximumObjectSize")).toLongLong() * 1024);
+}
+
+void NetworkCache::scheduleEviction()
+{
+	if (m_evictionTimer == 0)
+	{
+		m_evictionTimer = startTimer(250);
+	}
+}
+
+void NetworkCache::prepareEviction()
+{
+	m_evictionQueue.clear();
+
+	QVector<qint64> excess(m_typeSizes.count(), 0);
+	qint64 totalExcess = ((m_totalSize > maximumCacheSize()) ? (m_totalSize - (maximumCacheSize() * 9 / 10)) : 0);
+	bool needsEviction = (totalExcess > 0);
+
+	for (int i = 0; i < m_typeSizes.count(); ++i)
+	{
+		if (m_typeLimits[i] > 0 && m_typeSizes[i] > m_typeLimits[i])
+		{
+			excess[i] = (m_typeSizes[i] - (m_typeLimits[i] * 9 / 10));
+
+			needsEviction = true;
+		}
+	}
+
+	if (!needsEviction)
+	{
+		return;
+	}
+
+	QMultiMap<double, QUrl> candidates;
+	QHash<QUrl, NetworkCacheEntry>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		candidates.insert((iterator.value().lastAccessed.toTime_t() + (qLn(1 + iterator.value().accesses) * 86400)), iterator.key());
+	}
+
+	QMultiMap<double, QUrl>::const_iterator candidatesIterator;
+
+	for (candidatesIterator = candidates.constBegin(); candidatesIterator != candidates.constEnd(); ++candidatesIterator)
+	{
+		const NetworkCacheEntry &entry = m_entries[candidatesIterator.value()];
+		const ResourceType type = getResourceType(entry.contentType);
+
+		if (totalExcess <= 0 && excess[type] <= 0)
+		{
+			continue;
+		}
+
+		m_evictionQueue.append(entry.url);
+
+		totalExcess -= entry.size;
+		excess[type] -= entry.size;
+
+		bool isDone = (totalExcess <= 0);
+
+		for (int i = 0; (isDone && i < excess.count()); ++i)
+		{
+			isDone = (excess[i] <= 0);
+		}
+
+		if (isDone)
+		{
+			break;
+		}
+	}
+}
+
+QIODevice* NetworkCache::data(const QUrl &url)
+{
+	if (m_memoryData.contains(url))
+	{
+		++m_memoryHits;
+
+		if (m_isIndexLoaded && m_entries.contains(url))
+		{
+			m_entries[url].lastAccessed = QDateTime::currentDateTime();
+
+			++m_entries[url].accesses;
+		}
+
+		QBuffer *buffer = new QBuffer();
+		buffer->setData(*m_memoryData.object(url));
+		buffer->open(QIODevice::ReadOnly);
+
+		return buffer;
+	}
+
+	++m_memoryMisses;
+
+	QIODevice *device = QNetworkDiskCache::data(url);
+
+	if (!device)
+	{
+		return NULL;
+	}
+
+	if (m_isIndexLoaded && m_entries.contains(url))
+	{
+		m_entries[url].lastAccessed = QDateTime::currentDateTime();
+
+		++m_entries[url].accesses;
+	}
+
+	const int memoryLimit = qMin(524288, (m_memoryData.maxCost() / 4));
+	const bool isCompressed = metaData(url).attributes().value(CompressedAttribute).toBool();
+
+	if (!isCompressed && (memoryLimit <= 0 || device->size() > memoryLimit))
+	{
+		return device;
+	}
+
+	const QByteArray rawData = device->readAll();
+	QByteArray *data = new QByteArray(isCompressed ? qUncompress(rawData) : rawData);
+
+	delete device;
+
+	if (isCompressed && data->isEmpty() && (rawData.size() < 4 || rawData.left(4) != QByteArray(4, '\0')))
+	{
+		delete data;
+
+		remove(url);
+
+		return NULL;
+	}
+
+	QBuffer *buffer = new QBuffer();
+	buffer->setData(*data);
+	buffer->open(QIODevice::ReadOnly);
+
+	if (memoryLimit > 0 && data->size() <= memoryLimit)
+	{
+		m_memoryData.insert(url, data, data->size());
+	}
+	else
+	{
+		delete data;
+	}
+
+	return buffer;
+}
+
+QIODevice* NetworkCache::prepare(const QNetworkCacheMetaData &metaData)
+{
+	if (m_objectSizeLimit > 0 && getHeader(metaData, QByteArray("content-length")).toLongLong() > m_objectSizeLimit)
+	{
+		return NULL;
+	}
+
+	QNetworkCacheMetaData cacheMetaData(metaData);
+	QNetworkCacheMetaData::AttributesMap attributes = cacheMetaData.attributes();
+	attributes.remove(CompressedAttribute);
+
+	if (m_compressResources && metaData.isValid() && metaData.url().isValid() && metaData.saveToDisk() && isCompressible(QString(getHeader(metaData, QByteArray("content-type")))))
+	{
+		attributes[CompressedAttribute] = true;
+
+		cacheMetaData.setAttributes(attributes);
+
+		QBuffer *buffer = new QBuffer(this);
+		buffer->open(QIODevice::ReadWrite);
+
+		m_devices[buffer] = cacheMetaData;
+		m_compressedDevices.insert(buffer);
+
+		return buffer;
+	}
+
+	cacheMetaData.setAttributes(attributes);
+
+	QIODevice *device = QNetworkDiskCache::prepare(cacheMetaData);
+
+	if (device)
+	{
+		m_devices[device] = cacheMetaData;
+	}
+
+	return device;
+}
+
+QString NetworkCache::getIndexPath() const
+{
+	return QDir(cacheDirectory()).absoluteFilePath(QLatin1String("index.dat"));
+}
+
+QString NetworkCache::getJournalPath() const
+{
+	return QDir(cacheDirectory()).absoluteFilePath(QLatin1String("index.journal"));
+}
+
+QByteArray NetworkCache::getHeader(const QNetworkCacheMetaData &metaData, const QByteArray &name)
+{
+	const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		if (headers.at(i).first.toLower() == name)
+		{
+			return headers.at(i).second;
+		}
+	}
+
+	return QByteArray();
+}
+
+NetworkCache::ResourceType NetworkCache::getResourceType(const QString &contentType)
+{
+	const QString mimeType = contentType.section(QLatin1Char(';'), 0, 0).trimmed().toLower();
+
+	if (mimeType.isEmpty())
+	{
+		return OtherResource;
+	}
+
+	if (mimeType.startsWith(QLatin1String("image/")))
+	{
+		return ImageResource;
+	}
+
+	if (mimeType.startsWith(QLatin1String("video/")) || mimeType.startsWith(QLatin1String("audio/")))
+	{
+		return MediaResource;
+	}
+
+	if (mimeType == QLatin1String("text/css") || mimeType.contains(QLatin1String("javascript")) || mimeType.contains(QLatin1String("ecmascript")) || mimeType.startsWith(QLatin1String("font/")) || mimeType.startsWith(QLatin1String("application/font")) || mimeType.startsWith(QLatin1String("application/x-font")))
+	{
+		return ScriptResource;
+	}
+
+	if (mimeType.startsWith(QLatin1String("text/")) || mimeType.contains(QLatin1String("html")) || mimeType.contains(QLatin1String("xml")) || mimeType.contains(QLatin1String("json")))
+	{
+		return DocumentResource;
+	}
+
+	return OtherResource;
+}
+
+bool NetworkCache::isCompressible(const QString &contentType)
+{
+	const QString mimeType = contentType.section(QLatin1Char(';'), 0, 0).trimmed().toLower();
+
+	return (mimeType.startsWith(QLatin1String("text/")) || mimeType.contains(QLatin1String("javascript")) || mimeType.contains(QLatin1String("ecmascript")) || mimeType.contains(QLatin1String("json")) || mimeType.contains(QLatin1String("xml")));
+}
+
+QString NetworkCache::getPathForUrl(const QUrl &url)
+{
+	loadIndex();
+
+	if (!url.isValid() || !m_entries.contains(url))
+	{
+		return QString();
+	}
+
+	const QString path = m_entries.value(url).path;
+
+	if (path.isEmpty())
+	{
+		return QString();
+	}
+
+	return QDir(cacheDirectory()).absoluteFilePath(path);
+}
+
+NetworkCacheEntry NetworkCache::getEntry(const QUrl &url)
+{
+	loadIndex();
+
+	return m_entries.value(url);
+}
+
+QNetworkCacheMetaData NetworkCache::metaData(const QUrl &url)
+{
+	if (m_memoryMetaData.contains(url))
+	{
+		return *m_memoryMetaData.object(url);
+	}
+
+	const QNetworkCacheMetaData metaData = QNetworkDiskCache::metaData(url);
+
+	if (metaData.isValid())
+	{
+		m_memoryMetaData.insert(url, new QNetworkCacheMetaData(metaData));
+	}
+
+	return metaData;
+}
+
+QList<QUrl> NetworkCache::getEntries(int period)
+{
+	loadIndex();
+
+	if (period <= 0)
+	{
+		return m_entries.keys();
+	}
+
+	const QDateTime currentDateTime = QDateTime::currentDateTime();
+	QList<QUrl> entries;
+	QHash<QUrl, NetworkCacheEntry>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		if (iterator.value().lastModified.isValid() && iterator.value().lastModified.secsTo(currentDateTime) > (period * 3600))
+		{
+			entries.append(iterator.key());
 		}
 	}
 
 	return entries;
 }
 
+QByteArray NetworkCache::decompressData(const QNetworkCacheMetaData &metaData, const QByteArray &data)
+{
+	return (metaData.attributes().value(CompressedAttribute).toBool() ? qUncompress(data) : data);
+}
+
+qint64 NetworkCache::expire()
+{
+	if (cacheDirectory().isEmpty())
+	{
+		return QNetworkDiskCache::expire();
+	}
+
+	loadIndex();
+
+	if (m_totalSize > maximumCacheSize())
+	{
+		scheduleEviction();
+	}
+
+	return m_totalSize;
+}
+
+qint64 NetworkCache::getMemoryHits() const
+{
+	return m_memoryHits;
+}
+
+qint64 NetworkCache::getMemoryMisses() const
+{
+	return m_memoryMisses;
+}
+
 bool NetworkCache::remove(const QUrl &url)
 {
+	m_memoryData.remove(url);
+	m_memoryMetaData.remove(url);
+
+	QSet<QIODevice*>::iterator iterator = m_compressedDevices.begin();
+
+	while (iterator != m_compressedDevices.end())
+	{
+		if (m_devices.value(*iterator).url() == url)
+		{
+			m_devices.remove(*iterator);
+
+			(*iterator)->deleteLater();
+
+			iterator = m_compressedDevices.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	const bool wasIndexed = m_entries.contains(url);
 	const bool result = QNetworkDiskCache::remove(url);
 
-	if (result)
+	removeIndexEntry(url);
+
+	if (result || wasIndexed)
 	{
+		NetworkCacheEntry entry;
+		entry.url = url;
+
+		writeJournal(entry, true);
+
 		emit entryRemoved(url);
 	}
 
@@ -188,6 +880,20 @@ void NetworkCache::optionChanged(const QString &option, const QVariant &value)
 	if (option == QLatin1String("Cache/DiskCacheLimit"))
 	{
 		setMaximumCacheSize(value.toInt() * 1024);
+		updateLimits();
+	}
+	else if (option == QLatin1String("Cache/DocumentsBudget") || option == QLatin1String("Cache/ImagesBudget") || option == QLatin1String("Cache/MaximumObjectSize") || option == QLatin1String("Cache/MediaBudget") || option == QLatin1String("Cache/ScriptsBudget"))
+	{
+		updateLimits();
+		scheduleEviction();
+	}
+	else if (option == QLatin1String("Cache/CompressResources"))
+	{
+		m_compressResources = value.toBool();
+	}
+	else if (option == QLatin1String("Cache/MemoryCacheLimit"))
+	{
+		m_memoryData.setMaxCost(value.toInt() * 1024);
 	}
 }
 
@@ -20,30 +20,107 @@
 #ifndef OTTER_NETWORKCACHE_H
 #define OTTER_NETWORKCACHE_H
 
+#include <QtCore/QCache>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
 #include <QtNetwork/QNetworkDiskCache>
+#include <QtNetwork/QNetworkRequest>
 
 namespace Otter
 {
 
+struct NetworkCacheEntry
+{
+	QUrl url;
+	QString path;
+	QString contentType;
+	QDateTime lastModified;
+	QDateTime expirationDate;
+	QDateTime lastAccessed;
+	qint64 size;
+	int accesses;
+
+	NetworkCacheEntry() : size(0), accesses(0) {}
+};
+
 class NetworkCache : public QNetworkDiskCache
 {
 	Q_OBJECT
 
 public:
+	enum ResourceType
+	{
+		OtherResource = 0,
+		DocumentResource = 1,
+		ScriptResource = 2,
+		ImageResource = 3,
+		MediaResource = 4
+	};
+
 	explicit NetworkCache(QObject *parent = NULL);
+	~NetworkCache();
 
 	void clearCache(int period = 0);
 	void insert(QIODevice *device);
+	void updateMetaData(const QNetworkCacheMetaData &metaData);
+	QIODevice* data(const QUrl &url);
 	QIODevice* prepare(const QNetworkCacheMetaData &metaData);
 	QString getPathForUrl(const QUrl &url);
-	QList<QUrl> getEntries() const;
+	NetworkCacheEntry getEntry(const QUrl &url);
+	QNetworkCacheMetaData metaData(const QUrl &url);
+	QList<QUrl> getEntries(int period = 0);
+	static QByteArray decompressData(const QNetworkCacheMetaData &metaData, const QByteArray &data);
+	qint64 getMemoryHits() const;
+	qint64 getMemoryMisses() const;
 	bool remove(const QUrl &url);
 
+public slots:
+	void clear();
+
+protected:
+	void timerEvent(QTimerEvent *event);
+	void loadIndex();
+	void saveIndex();
+	void rebuildIndex();
+	void addIndexEntry(const NetworkCacheEntry &entry);
+	void removeIndexEntry(const QUrl &url);
+	void updateEntry(NetworkCacheEntry &entry, const QNetworkCacheMetaData &metaData);
+	void writeJournal(const NetworkCacheEntry &entry, bool isRemoved = false);
+	void updateLimits();
+	void scheduleEviction();
+	void prepareEviction();
+	QString getIndexPath() const;
+	QString getJournalPath() const;
+	static QByteArray getHeader(const QNetworkCacheMetaData &metaData, const QByteArray &name);
+	static ResourceType getResourceType(const QString &contentType);
+	qint64 expire();
+	static bool isCompressible(const QString &contentType);
+
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
 
 private:
-	QHash<QIODevice*, QUrl> m_devices;
+	QHash<QIODevice*, QNetworkCacheMetaData> m_devices;
+	QSet<QIODevice*> m_compressedDevices;
+	QHash<QUrl, NetworkCacheEntry> m_entries;
+	QFile *m_journal;
+	QCache<QUrl, QByteArray> m_memoryData;
+	QCache<QUrl, QNetworkCacheMetaData> m_memoryMetaData;
+	QList<QUrl> m_evictionQueue;
+	QVector<qint64> m_typeSizes;
+	QVector<qint64> m_typeLimits;
+	qint64 m_totalSize;
+	qint64 m_objectSizeLimit;
+	qint64 m_memoryHits;
+	qint64 m_memoryMisses;
+	int m_evictionTimer;
+	int m_journalSize;
+	bool m_compressResources;
+	bool m_isIndexLoaded;
+
+	static const QNetworkRequest::Attribute CompressedAttribute;
 
 signals:
 	void cleared();
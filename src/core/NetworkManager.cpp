@@ -36,18 +36,17 @@
 namespace Otter
 {
 
-NetworkManager::NetworkManager(bool isPrivate, QObject *parent) : QNetworkAccessManager(parent),
-	m_cookieJar(NULL)
+NetworkManager::NetworkManager(bool isPrivate, QObject *parent) : QNetworkAccessManager(parent)
 {
 	NetworkManagerFactory::initialize();
 
 	if (!isPrivate)
 	{
-		m_cookieJar = NetworkManagerFactory::getCookieJar();
+		CookieJar *cookieJar = NetworkManagerFactory::getCookieJar();
 
-		setCookieJar(m_cookieJar);
+		setCookieJar(cookieJar);
 
-		m_cookieJar->setParent(QCoreApplication::instance());
+		cookieJar->setParent(QCoreApplication::instance());
 
 		QNetworkDiskCache *cache = NetworkManagerFactory::getCache();
 
@@ -57,14 +56,13 @@ NetworkManager::NetworkManager(bool isPrivate, QObject *parent) : QNetworkAccess
 	}
 	else
 	{
-		m_cookieJar = new CookieJar(true, this);
-
-		setCookieJar(m_cookieJar);
+		setCookieJar(new CookieJar(true, this));
 	}
 
 	connect(this, SIGNAL(authenticationRequired(QNetworkReply*,QAuthenticator*)), this, SLOT(handleAuthenticationRequired(QNetworkReply*,QAuthenticator*)));
 	connect(this, SIGNAL(proxyAuthenticationRequired(QNetworkProxy,QAuthenticator*)), this, SLOT(handleProxyAuthenticationRequired(QNetworkProxy,QAuthenticator*)));
 	connect(this, SIGNAL(sslErrors(QNetworkReply*,QList<QSslError>)), this, SLOT(handleSslErrors(QNetworkReply*,QList<QSslError>)));
+	connect(this, SIGNAL(finished(QNetworkReply*)), NetworkManagerFactory::getInstance(), SLOT(transportRequestFinished(QNetworkReply*)));
 }
 
 void NetworkManager::handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
@@ -132,7 +130,7 @@ void NetworkManager::handleSslErrors(QNetworkReply *reply, const QList<QSslError
 
 CookieJar* NetworkManager::getCookieJar()
 {
-	return m_cookieJar;
+	return qobject_cast<CookieJar*>(cookieJar());
 }
 
 QNetworkReply* NetworkManager::createRequest(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QIODevice *outgoingData)
@@ -165,6 +163,8 @@ QNetworkReply* NetworkManager::createRequest(QNetworkAccessManager::Operation op
 
 	mutableRequest.setRawHeader(QStringLiteral("Accept-Language").toLatin1(), NetworkManagerFactory::getAcceptLanguage().toLatin1());
 
+	NetworkManagerFactory::setupMultiplexing(mutableRequest);
+
 	return QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
 }
 
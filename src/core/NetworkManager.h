@@ -43,9 +43,6 @@ protected slots:
 	virtual void handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator);
 	virtual void handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
 	virtual void handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
-
-private:
-	CookieJar *m_cookieJar;
 };
 
 }
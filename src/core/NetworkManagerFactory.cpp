@@ -19,15 +19,18 @@
 **************************************************************************/
 
 #include "NetworkManagerFactory.h"
+#include "Console.h"
 #include "ContentBlockingManager.h"
 #include "CookieJar.h"
 #include "NetworkCache.h"
 #include "NetworkManager.h"
+#include "NetworkMemoryCache.h"
 #include "NetworkProxyFactory.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 #include "WebBackend.h"
 #include "WebBackendsManager.h"
+#include "../ui/AuthenticationDialog.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QFile>
@@ -40,11 +43,16 @@ namespace Otter
 NetworkManagerFactory* NetworkManagerFactory::m_instance = NULL;
 CookieJar* NetworkManagerFactory::m_cookieJar = NULL;
 NetworkCache* NetworkManagerFactory::m_cache = NULL;
+NetworkMemoryCache* NetworkManagerFactory::m_privateCache = NULL;
+QNetworkAccessManager* NetworkManagerFactory::m_transportManager = NULL;
+QNetworkAccessManager* NetworkManagerFactory::m_privateTransportManager = NULL;
 QString NetworkManagerFactory::m_acceptLanguage;
 QStringList NetworkManagerFactory::m_userAgentsOrder;
 QMap<QString, UserAgentInformation> NetworkManagerFactory::m_userAgents;
 NetworkManagerFactory::DoNotTrackPolicy NetworkManagerFactory::m_doNotTrackPolicy = NetworkManagerFactory::SkipTrackPolicy;
 QList<QSslCipher> NetworkManagerFactory::m_defaultCiphers;
+QHash<QString, QPair<bool, bool> > NetworkManagerFactory::m_multiplexingOptions;
+QSet<QString> NetworkManagerFactory::m_multiplexingBlacklist;
 bool NetworkManagerFactory::m_canSendReferrer = true;
 bool NetworkManagerFactory::m_isWorkingOffline = false;
 bool NetworkManagerFactory::m_isInitialized = false;
@@ -124,6 +132,10 @@ void NetworkManagerFactory::optionChanged(const QString &option, const QVariant
 			m_doNotTrackPolicy = SkipTrackPolicy;
 		}
 	}
+	else if (option == QLatin1String("Network/EnablePipelining") || option == QLatin1String("Network/EnableSpdy"))
+	{
+		m_multiplexingOptions.clear();
+	}
 	else if (option == QLatin1String("Network/EnableReferrer"))
 	{
 		m_canSendReferrer = value.toBool();
@@ -161,11 +173,52 @@ void NetworkManagerFactory::optionChanged(const QString &option, const QVariant
 	}
 }
 
+void NetworkManagerFactory::handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator)
+{
+	if (isUsingSystemProxyAuthentication())
+	{
+		authenticator->setUser(QString());
+
+		return;
+	}
+
+	AuthenticationDialog dialog(QUrl(proxy.hostName()), authenticator, SessionsManager::getActiveWindow());
+	dialog.exec();
+}
+
+void NetworkManagerFactory::clearPrivateTransportManager()
+{
+	if (m_privateTransportManager)
+	{
+		m_privateTransportManager->clearAccessCache();
+	}
+}
+
+void NetworkManagerFactory::transportRequestFinished(QNetworkReply *reply)
+{
+	if (!reply || reply->error() == QNetworkReply::NoError || !canUseMultiplexing(reply->url().host()))
+	{
+		return;
+	}
+
+	const QNetworkRequest request = reply->request();
+	bool wasAllowed = request.attribute(QNetworkRequest::HttpPipeliningAllowedAttribute).toBool();
+
+#if QT_VERSION >= 0x050300
+	wasAllowed = (wasAllowed || request.attribute(QNetworkRequest::SpdyAllowedAttribute).toBool());
+#endif
+
+	if (wasAllowed && (reply->error() == QNetworkReply::RemoteHostClosedError || reply->error() == QNetworkReply::ProtocolFailure || reply->error() == QNetworkReply::UnknownNetworkError))
+	{
+		disableMultiplexing(reply->url().host());
+	}
+}
+
 void NetworkManagerFactory::clearCookies(int period)
 {
 	if (!m_cookieJar)
 	{
-		m_cookieJar = new CookieJar(QCoreApplication::instance());
+		m_cookieJar = new CookieJar(false, QCoreApplication::instance());
 	}
 
 	m_cookieJar->clearCookies(period);
@@ -176,6 +229,38 @@ void NetworkManagerFactory::clearCache(int period)
 	m_cache->clearCache(period);
 }
 
+void NetworkManagerFactory::disableMultiplexing(const QString &host)
+{
+	if (host.isEmpty() || m_multiplexingBlacklist.contains(host))
+	{
+		return;
+	}
+
+	m_multiplexingBlacklist.insert(host);
+
+	Console::addMessage(QCoreApplication::translate("main", "Disabled pipelining and multiplexing for host %0 after failed request").arg(host), NetworkMessageCategory, WarningMessageLevel);
+}
+
+void NetworkManagerFactory::setupMultiplexing(QNetworkRequest &request)
+{
+	const QString host = request.url().host();
+
+	if (!canUseMultiplexing(host))
+	{
+		return;
+	}
+
+	if (!m_multiplexingOptions.contains(host))
+	{
+		m_multiplexingOptions[host] = qMakePair(SettingsManager::getValue(QLatin1String("Network/EnablePipelining"), request.url()).toBool(), SettingsManager::getValue(QLatin1String("Network/EnableSpdy"), request.url()).toBool());
+	}
+
+	request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, m_multiplexingOptions[host].first);
+#if QT_VERSION >= 0x050300
+	request.setAttribute(QNetworkRequest::SpdyAllowedAttribute, m_multiplexingOptions[host].second);
+#endif
+}
+
 void NetworkManagerFactory::loadUserAgents()
 {
 	const QString path = (SessionsManager::getProfilePath() + QLatin1String("/userAgents.ini"));
@@ -222,6 +307,50 @@ NetworkCache* NetworkManagerFactory::getCache()
 	return m_cache;
 }
 
+NetworkMemoryCache* NetworkManagerFactory::getPrivateCache()
+{
+	if (!m_privateCache)
+	{
+		m_privateCache = new NetworkMemoryCache(QCoreApplication::instance());
+
+		connect(m_privateCache, SIGNAL(managersRemoved()), m_instance, SLOT(clearPrivateTransportManager()));
+	}
+
+	return m_privateCache;
+}
+
+QNetworkAccessManager* NetworkManagerFactory::getTransportManager(bool isPrivate)
+{
+	QNetworkAccessManager *manager = (isPrivate ? m_privateTransportManager : m_transportManager);
+
+	if (manager)
+	{
+		return manager;
+	}
+
+	manager = new QNetworkAccessManager(QCoreApplication::instance());
+
+	QAbstractNetworkCache *cache = (isPrivate ? static_cast<QAbstractNetworkCache*>(getPrivateCache()) : static_cast<QAbstractNetworkCache*>(getCache()));
+
+	manager->setCache(cache);
+
+	cache->setParent(QCoreApplication::instance());
+
+	connect(manager, SIGNAL(proxyAuthenticationRequired(QNetworkProxy,QAuthenticator*)), m_instance, SLOT(handleProxyAuthenticationRequired(QNetworkProxy,QAuthenticator*)));
+	connect(manager, SIGNAL(finished(QNetworkReply*)), m_instance, SLOT(transportRequestFinished(QNetworkReply*)));
+
+	if (isPrivate)
+	{
+		m_privateTransportManager = manager;
+	}
+	else
+	{
+		m_transportManager = manager;
+	}
+
+	return manager;
+}
+
 QString NetworkManagerFactory::getAcceptLanguage()
 {
 	return m_acceptLanguage;
@@ -282,6 +411,11 @@ bool NetworkManagerFactory::canSendReferrer()
 	return m_canSendReferrer;
 }
 
+bool NetworkManagerFactory::canUseMultiplexing(const QString &host)
+{
+	return !m_multiplexingBlacklist.contains(host);
+}
+
 bool NetworkManagerFactory::isWorkingOffline()
 {
 	return m_isWorkingOffline;
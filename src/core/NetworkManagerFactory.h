@@ -22,8 +22,12 @@
 #define OTTER_NETWORKMANAGERFACTORY_H
 
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtNetwork/QNetworkCookieJar>
+#include <QtNetwork/QAuthenticator>
 #include <QtNetwork/QNetworkDiskCache>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QSslCipher>
 
 namespace Otter
@@ -40,6 +44,7 @@ class ContentsWidget;
 class CookieJar;
 class NetworkCache;
 class NetworkManager;
+class NetworkMemoryCache;
 
 class NetworkManagerFactory : public QObject
 {
@@ -58,15 +63,20 @@ public:
 	static void clearCookies(int period = 0);
 	static void clearCache(int period = 0);
 	static void loadUserAgents();
+	static void disableMultiplexing(const QString &host);
+	static void setupMultiplexing(QNetworkRequest &request);
 	static NetworkManagerFactory* getInstance();
 	static CookieJar* getCookieJar();
 	static NetworkCache* getCache();
+	static NetworkMemoryCache* getPrivateCache();
+	static QNetworkAccessManager* getTransportManager(bool isPrivate);
 	static QString getAcceptLanguage();
 	static QStringList getUserAgents();
 	static QList<QSslCipher> getDefaultCiphers();
 	static UserAgentInformation getUserAgent(const QString &identifier);
 	static DoNotTrackPolicy getDoNotTrackPolicy();
 	static bool canSendReferrer();
+	static bool canUseMultiplexing(const QString &host);
 	static bool isWorkingOffline();
 	static bool isUsingSystemProxyAuthentication();
 
@@ -77,15 +87,23 @@ protected:
 
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
+	void handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
+	void clearPrivateTransportManager();
+	void transportRequestFinished(QNetworkReply *reply);
 
 private:
 	static NetworkManagerFactory *m_instance;
 	static CookieJar *m_cookieJar;
 	static NetworkCache *m_cache;
+	static NetworkMemoryCache *m_privateCache;
+	static QNetworkAccessManager *m_transportManager;
+	static QNetworkAccessManager *m_privateTransportManager;
 	static QString m_acceptLanguage;
 	static QStringList m_userAgentsOrder;
 	static QMap<QString, UserAgentInformation> m_userAgents;
 	static QList<QSslCipher> m_defaultCiphers;
+	static QHash<QString, QPair<bool, bool> > m_multiplexingOptions;
+	static QSet<QString> m_multiplexingBlacklist;
 	static DoNotTrackPolicy m_doNotTrackPolicy;
 	static bool m_canSendReferrer;
 	static bool m_isWorkingOffline;
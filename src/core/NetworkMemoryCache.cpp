@@ -0,0 +1,177 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkMemoryCache.h"
+#include "SettingsManager.h"
+
+#include <QtCore/QBuffer>
+
+namespace Otter
+{
+
+NetworkMemoryCache::NetworkMemoryCache(QObject *parent) : QAbstractNetworkCache(parent)
+{
+	m_entries.setMaxCost(SettingsManager::getValue(QLatin1String("Cache/PrivateCacheLimit")).toInt() * 1024);
+
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+}
+
+void NetworkMemoryCache::addManager(QNetworkAccessManager *manager)
+{
+	if (!manager || m_managers.contains(manager))
+	{
+		return;
+	}
+
+	m_managers.insert(manager);
+
+	connect(manager, SIGNAL(destroyed(QObject*)), this, SLOT(removeManager(QObject*)));
+}
+
+void NetworkMemoryCache::insert(QIODevice *device)
+{
+	if (!m_devices.contains(device))
+	{
+		return;
+	}
+
+	QBuffer *buffer = qobject_cast<QBuffer*>(device);
+	NetworkMemoryCacheEntry *entry = new NetworkMemoryCacheEntry();
+	entry->metaData = m_devices.take(device);
+
+	if (buffer)
+	{
+		entry->data = buffer->data();
+	}
+
+	m_entries.insert(entry->metaData.url(), entry, qMax(1, entry->data.size()));
+
+	device->deleteLater();
+}
+
+void NetworkMemoryCache::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+	NetworkMemoryCacheEntry *entry = m_entries.object(metaData.url());
+
+	if (entry)
+	{
+		entry->metaData = metaData;
+	}
+}
+
+void NetworkMemoryCache::clear()
+{
+	m_entries.clear();
+}
+
+void NetworkMemoryCache::optionChanged(const QString &option, const QVariant &value)
+{
+	if (option == QLatin1String("Cache/PrivateCacheLimit"))
+	{
+		m_entries.setMaxCost(value.toInt() * 1024);
+	}
+}
+
+void NetworkMemoryCache::removeManager(QObject *manager)
+{
+	m_managers.remove(manager);
+
+	if (m_managers.isEmpty())
+	{
+		clear();
+
+		emit managersRemoved();
+	}
+}
+
+QIODevice* NetworkMemoryCache::data(const QUrl &url)
+{
+	NetworkMemoryCacheEntry *entry = m_entries.object(url);
+
+	if (!entry)
+	{
+		return NULL;
+	}
+
+	QBuffer *buffer = new QBuffer();
+	buffer->setData(entry->data);
+	buffer->open(QIODevice::ReadOnly);
+
+	return buffer;
+}
+
+QIODevice* NetworkMemoryCache::prepare(const QNetworkCacheMetaData &metaData)
+{
+	if (!metaData.isValid() || !metaData.url().isValid() || !metaData.saveToDisk() || m_entries.maxCost() <= 0)
+	{
+		return NULL;
+	}
+
+	const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		if (headers.at(i).first.toLower() == QByteArray("content-length") && headers.at(i).second.toLongLong() > m_entries.maxCost())
+		{
+			return NULL;
+		}
+	}
+
+	QBuffer *buffer = new QBuffer(this);
+	buffer->open(QIODevice::ReadWrite);
+
+	m_devices[buffer] = metaData;
+
+	return buffer;
+}
+
+QNetworkCacheMetaData NetworkMemoryCache::metaData(const QUrl &url)
+{
+	NetworkMemoryCacheEntry *entry = m_entries.object(url);
+
+	return (entry ? entry->metaData : QNetworkCacheMetaData());
+}
+
+qint64 NetworkMemoryCache::cacheSize() const
+{
+	return m_entries.totalCost();
+}
+
+bool NetworkMemoryCache::remove(const QUrl &url)
+{
+	QHash<QIODevice*, QNetworkCacheMetaData>::iterator iterator = m_devices.begin();
+
+	while (iterator != m_devices.end())
+	{
+		if (iterator.value().url() == url)
+		{
+			iterator.key()->deleteLater();
+
+			iterator = m_devices.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	return m_entries.remove(url);
+}
+
+}
@@ -0,0 +1,71 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKMEMORYCACHE_H
+#define OTTER_NETWORKMEMORYCACHE_H
+
+#include <QtCore/QCache>
+#include <QtCore/QSet>
+#include <QtNetwork/QAbstractNetworkCache>
+#include <QtNetwork/QNetworkAccessManager>
+
+namespace Otter
+{
+
+struct NetworkMemoryCacheEntry
+{
+	QNetworkCacheMetaData metaData;
+	QByteArray data;
+};
+
+class NetworkMemoryCache : public QAbstractNetworkCache
+{
+	Q_OBJECT
+
+public:
+	explicit NetworkMemoryCache(QObject *parent = NULL);
+
+	void addManager(QNetworkAccessManager *manager);
+	void insert(QIODevice *device);
+	void updateMetaData(const QNetworkCacheMetaData &metaData);
+	QIODevice* data(const QUrl &url);
+	QIODevice* prepare(const QNetworkCacheMetaData &metaData);
+	QNetworkCacheMetaData metaData(const QUrl &url);
+	qint64 cacheSize() const;
+	bool remove(const QUrl &url);
+
+public slots:
+	void clear();
+
+protected slots:
+	void optionChanged(const QString &option, const QVariant &value);
+	void removeManager(QObject *manager);
+
+private:
+	QCache<QUrl, NetworkMemoryCacheEntry> m_entries;
+	QHash<QIODevice*, QNetworkCacheMetaData> m_devices;
+	QSet<QObject*> m_managers;
+
+signals:
+	void managersRemoved();
+};
+
+}
+
+#endif
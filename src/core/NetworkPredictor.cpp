@@ -0,0 +1,196 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#include "NetworkPredictor.h"
+#include "NetworkManagerFactory.h"
+#include "SettingsManager.h"
+
+#include <QtNetwork/QNetworkAccessManager>
+
+namespace Otter
+{
+
+NetworkPredictor* NetworkPredictor::m_instance = NULL;
+QHash<QString, QDateTime> NetworkPredictor::m_hosts;
+QHash<QString, QDateTime> NetworkPredictor::m_connections;
+QSet<QString> NetworkPredictor::m_pendingHosts;
+QElapsedTimer NetworkPredictor::m_requestsTimer;
+NetworkPredictor::PredictionMode NetworkPredictor::m_mode = NetworkPredictor::ResolveHostsPrediction;
+int NetworkPredictor::m_requests = 0;
+
+NetworkPredictor::NetworkPredictor(QObject *parent) : QObject(parent)
+{
+	optionChanged(QLatin1String("Network/PredictionMode"), SettingsManager::getValue(QLatin1String("Network/PredictionMode")));
+
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+}
+
+void NetworkPredictor::createInstance(QObject *parent)
+{
+	if (!m_instance)
+	{
+		m_instance = new NetworkPredictor(parent);
+	}
+}
+
+void NetworkPredictor::optionChanged(const QString &option, const QVariant &value)
+{
+	if (option == QLatin1String("Network/PredictionMode"))
+	{
+		const QString mode = value.toString();
+
+		if (mode == QLatin1String("disabled"))
+		{
+			m_mode = DisabledPrediction;
+		}
+		else if (mode == QLatin1String("preconnect"))
+		{
+			m_mode = PreconnectPrediction;
+		}
+		else
+		{
+			m_mode = ResolveHostsPrediction;
+		}
+	}
+}
+
+void NetworkPredictor::hostResolved(const QHostInfo &host)
+{
+	const QString name = host.hostName().toLower();
+
+	m_pendingHosts.remove(name);
+
+	if (host.error() == QHostInfo::NoError)
+	{
+		m_hosts[name] = QDateTime::currentDateTimeUtc().addSecs(60);
+	}
+}
+
+void NetworkPredictor::predictUrl(const QUrl &url, bool isPrivate)
+{
+	if (isPrivate || !m_instance || m_mode == DisabledPrediction || NetworkManagerFactory::isWorkingOffline() || !url.isValid() || url.host().isEmpty() || (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")))
+	{
+		return;
+	}
+
+	if (m_mode == PreconnectPrediction)
+	{
+		connectToHost(url);
+	}
+	else
+	{
+		resolveHost(url.host().toLower());
+	}
+}
+
+void NetworkPredictor::resolveHost(const QString &host)
+{
+	if (m_pendingHosts.contains(host) || (m_hosts.contains(host) && m_hosts[host] > QDateTime::currentDateTimeUtc()) || !canStartRequest())
+	{
+		return;
+	}
+
+	purgeCache(m_hosts);
+
+	m_pendingHosts.insert(host);
+
+	QHostInfo::lookupHost(host, m_instance, SLOT(hostResolved(QHostInfo)));
+}
+
+void NetworkPredictor::connectToHost(const QUrl &url)
+{
+	const bool isSecure = (url.scheme() == QLatin1String("https"));
+	const quint16 port = url.port(isSecure ? 443 : 80);
+	const QString key = QStringLiteral("%1://%2:%3").arg(url.scheme()).arg(url.host().toLower()).arg(port);
+
+	if ((m_connections.contains(key) && m_connections[key] > QDateTime::currentDateTimeUtc()) || !canStartRequest())
+	{
+		return;
+	}
+
+	purgeCache(m_connections);
+
+	m_connections[key] = QDateTime::currentDateTimeUtc().addSecs(30);
+
+	QNetworkAccessManager *manager = NetworkManagerFactory::getTransportManager(false);
+
+	if (isSecure)
+	{
+		manager->connectToHostEncrypted(url.host(), port);
+	}
+	else
+	{
+		manager->connectToHost(url.host(), port);
+	}
+}
+
+void NetworkPredictor::purgeCache(QHash<QString, QDateTime> &cache)
+{
+	if (cache.count() < 256)
+	{
+		return;
+	}
+
+	const QDateTime currentDateTime = QDateTime::currentDateTimeUtc();
+	QHash<QString, QDateTime>::iterator iterator = cache.begin();
+
+	while (iterator != cache.end())
+	{
+		if (iterator.value() <= currentDateTime)
+		{
+			iterator = cache.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	if (cache.count() >= 256)
+	{
+		cache.clear();
+	}
+}
+
+NetworkPredictor* NetworkPredictor::getInstance()
+{
+	return m_instance;
+}
+
+bool NetworkPredictor::canStartRequest()
+{
+	if (!m_requestsTimer.isValid() || m_requestsTimer.elapsed() > 1000)
+	{
+		m_requestsTimer.start();
+
+		m_requests = 0;
+	}
+
+	if (m_requests >= 8 || m_pendingHosts.count() >= 4)
+	{
+		return false;
+	}
+
+	++m_requests;
+
+	return true;
+}
+
+}
@@ -0,0 +1,76 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#ifndef OTTER_NETWORKPREDICTOR_H
+#define OTTER_NETWORKPREDICTOR_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QUrl>
+#include <QtNetwork/QHostInfo>
+
+namespace Otter
+{
+
+class NetworkPredictor : public QObject
+{
+	Q_OBJECT
+	Q_ENUMS(PredictionMode)
+
+public:
+	enum PredictionMode
+	{
+		DisabledPrediction = 0,
+		ResolveHostsPrediction = 1,
+		PreconnectPrediction = 2
+	};
+
+	static void createInstance(QObject *parent = NULL);
+	static void predictUrl(const QUrl &url, bool isPrivate);
+	static NetworkPredictor* getInstance();
+
+protected:
+	explicit NetworkPredictor(QObject *parent = NULL);
+
+	static void resolveHost(const QString &host);
+	static void connectToHost(const QUrl &url);
+	static void purgeCache(QHash<QString, QDateTime> &cache);
+	static bool canStartRequest();
+
+protected slots:
+	void optionChanged(const QString &option, const QVariant &value);
+	void hostResolved(const QHostInfo &host);
+
+private:
+	static NetworkPredictor *m_instance;
+	static QHash<QString, QDateTime> m_hosts;
+	static QHash<QString, QDateTime> m_connections;
+	static QSet<QString> m_pendingHosts;
+	static QElapsedTimer m_requestsTimer;
+	static PredictionMode m_mode;
+	static int m_requests;
+};
+
+}
+
+#endif
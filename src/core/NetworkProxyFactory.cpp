@@ -30,6 +30,7 @@ namespace Otter
 
 NetworkProxyFactory::NetworkProxyFactory() : QObject(), QNetworkProxyFactory(),
 	m_automaticProxy(NULL),
+	m_automaticProxyThread(NULL),
 	m_proxyMode(SystemProxy)
 {
 	optionChanged(QLatin1String("Network/ProxyMode"));
@@ -39,9 +40,10 @@ NetworkProxyFactory::NetworkProxyFactory() : QObject(), QNetworkProxyFactory(),
 
 NetworkProxyFactory::~NetworkProxyFactory()
 {
-	if (m_automaticProxy)
+	if (m_automaticProxyThread)
 	{
-		delete m_automaticProxy;
+		m_automaticProxyThread->quit();
+		m_automaticProxyThread->wait();
 	}
 }
 
@@ -53,13 +55,32 @@ void NetworkProxyFactory::optionChanged(const QString &option)
 
 		if (!m_automaticProxy)
 		{
+			qRegisterMetaType<QList<QNetworkProxy> >("QList<QNetworkProxy>");
+
 			m_automaticProxy = new NetworkAutomaticProxy();
+			m_automaticProxyThread = new QThread(this);
+
+			m_automaticProxy->moveToThread(m_automaticProxyThread);
+
+			connect(m_automaticProxyThread, SIGNAL(finished()), m_automaticProxy, SLOT(deleteLater()));
+
+			m_automaticProxyThread->start();
 		}
 
+		m_automaticProxiesMutex.lock();
+		m_automaticProxies.clear();
+		m_automaticProxiesMutex.unlock();
+
 		const QString path = SettingsManager::getValue(QLatin1String("Proxy/AutomaticConfigurationPath")).toString();
 		QFile file(path);
+		bool result = false;
+
+		if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+		{
+			QMetaObject::invokeMethod(m_automaticProxy, "setup", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, result), Q_ARG(QString, QString(file.readAll())));
+		}
 
-		if (!file.open(QIODevice::ReadOnly | QIODevice::Text) || !m_automaticProxy->setup(file.readAll()))
+		if (!result)
 		{
 			Console::addMessage(tr("Failed to setup proxy auto-config (PAC)"), NetworkMessageCategory, ErrorMessageLevel, path);
 
@@ -145,7 +166,45 @@ QList<QNetworkProxy> NetworkProxyFactory::queryProxy(const QNetworkProxyQuery &q
 
 	if (m_proxyMode == AutomaticProxy && m_automaticProxy)
 	{
-		return m_automaticProxy->getProxy(query.url().toString(), query.peerHostName());
+		const QString key = (query.url().scheme() + QLatin1String("://") + query.peerHostName());
+		const QDateTime currentDateTime = QDateTime::currentDateTimeUtc();
+
+		m_automaticProxiesMutex.lock();
+
+		if (m_automaticProxies.contains(key) && m_automaticProxies[key].second > currentDateTime)
+		{
+			const QList<QNetworkProxy> proxies = m_automaticProxies[key].first;
+
+			m_automaticProxiesMutex.unlock();
+
+			return proxies;
+		}
+
+		m_automaticProxiesMutex.unlock();
+
+		QList<QNetworkProxy> proxies;
+
+		if (QThread::currentThread() == m_automaticProxyThread)
+		{
+			proxies = m_automaticProxy->getProxy(query.url().toString(), query.peerHostName());
+		}
+		else
+		{
+			QMetaObject::invokeMethod(m_automaticProxy, "getProxy", Qt::BlockingQueuedConnection, Q_RETURN_ARG(QList<QNetworkProxy>, proxies), Q_ARG(QString, query.url().toString()), Q_ARG(QString, query.peerHostName()));
+		}
+
+		m_automaticProxiesMutex.lock();
+
+		if (m_automaticProxies.count() > 1000)
+		{
+			m_automaticProxies.clear();
+		}
+
+		m_automaticProxies[key] = qMakePair(proxies, currentDateTime.addSecs(300));
+
+		m_automaticProxiesMutex.unlock();
+
+		return proxies;
 	}
 
 	return m_proxies[QLatin1String("NoProxy")];
@@ -23,6 +23,9 @@
 
 #include "NetworkAutomaticProxy.h"
 
+#include <QtCore/QDateTime>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
 #include <QtNetwork/QNetworkProxy>
 
 namespace Otter
@@ -52,7 +55,10 @@ protected slots:
 
 private:
 	NetworkAutomaticProxy *m_automaticProxy;
+	QThread *m_automaticProxyThread;
 	QHash<QString, QList<QNetworkProxy> > m_proxies;
+	QHash<QString, QPair<QList<QNetworkProxy>, QDateTime> > m_automaticProxies;
+	QMutex m_automaticProxiesMutex;
 	ProxyMode m_proxyMode;
 };
 
@@ -0,0 +1,205 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkScheduler.h"
+#include "DeferredNetworkReply.h"
+
+namespace Otter
+{
+
+NetworkScheduler* NetworkScheduler::m_instance = NULL;
+QList<QPointer<DeferredNetworkReply> > NetworkScheduler::m_queue;
+QHash<QObject*, QString> NetworkScheduler::m_activeRequests;
+QHash<QString, int> NetworkScheduler::m_hostRequests;
+QHash<QObject*, QPointer<QWidget> > NetworkScheduler::m_currentWindows;
+
+NetworkScheduler::NetworkScheduler(QObject *parent) : QObject(parent)
+{
+}
+
+void NetworkScheduler::createInstance(QObject *parent)
+{
+	if (!m_instance)
+	{
+		m_instance = new NetworkScheduler(parent);
+	}
+}
+
+void NetworkScheduler::requestFinished()
+{
+	requestDestroyed(sender());
+}
+
+void NetworkScheduler::requestDestroyed(QObject *object)
+{
+	if (!m_activeRequests.contains(object))
+	{
+		return;
+	}
+
+	const QString host = m_activeRequests.take(object);
+
+	--m_hostRequests[host];
+
+	if (m_hostRequests[host] <= 0)
+	{
+		m_hostRequests.remove(host);
+	}
+
+	startRequests();
+}
+
+void NetworkScheduler::removeWindowsManager(QObject *windowsManager)
+{
+	m_currentWindows.remove(windowsManager);
+
+	startRequests();
+}
+
+void NetworkScheduler::startRequests()
+{
+	for (int i = (m_queue.count() - 1); i >= 0; --i)
+	{
+		if (!m_queue.at(i) || m_queue.at(i)->isFinished())
+		{
+			m_queue.removeAt(i);
+		}
+	}
+
+	while (!m_queue.isEmpty())
+	{
+		int index = -1;
+		int priority = 0;
+
+		for (int i = 0; i < m_queue.count(); ++i)
+		{
+			const int requestPriority = getPriority(m_queue.at(i));
+
+			if (index >= 0 && requestPriority >= priority)
+			{
+				continue;
+			}
+
+			const int requests = m_hostRequests.value(getHost(m_queue.at(i)->request()));
+
+			// Current tab documents are never held back, background tabs get only a part of connections to each host
+			if (requestPriority == DocumentPriority || requests < ((requestPriority > PrefetchPriority) ? 2 : 6))
+			{
+				index = i;
+				priority = requestPriority;
+			}
+		}
+
+		if (index < 0)
+		{
+			break;
+		}
+
+		DeferredNetworkReply *reply = m_queue.takeAt(index);
+		const QString host = getHost(reply->request());
+
+		m_activeRequests[reply] = host;
+
+		++m_hostRequests[host];
+
+		if (priority == DocumentPriority)
+		{
+			reply->start(QNetworkRequest::HighPriority);
+		}
+		else
+		{
+			reply->start((priority < ImagePriority) ? QNetworkRequest::NormalPriority : QNetworkRequest::LowPriority);
+		}
+	}
+}
+
+void NetworkScheduler::setCurrentWindow(QObject *windowsManager, QWidget *window)
+{
+	if (!m_instance || !windowsManager)
+	{
+		return;
+	}
+
+	if (!m_currentWindows.contains(windowsManager))
+	{
+		connect(windowsManager, SIGNAL(destroyed(QObject*)), m_instance, SLOT(removeWindowsManager(QObject*)));
+	}
+
+	m_currentWindows[windowsManager] = window;
+
+	startRequests();
+}
+
+NetworkScheduler* NetworkScheduler::getInstance()
+{
+	return m_instance;
+}
+
+QNetworkReply* NetworkScheduler::createRequest(QNetworkAccessManager *transportManager, QNetworkAccessManager::Operation operation, const QNetworkRequest &request, RequestPriority priority, QWidget *widget, QObject *parent)
+{
+	DeferredNetworkReply *reply = new DeferredNetworkReply(transportManager, operation, request, priority, widget, parent);
+
+	if (!m_instance)
+	{
+		reply->start(request.priority());
+
+		return reply;
+	}
+
+	connect(reply, SIGNAL(finished()), m_instance, SLOT(requestFinished()));
+	connect(reply, SIGNAL(destroyed(QObject*)), m_instance, SLOT(requestDestroyed(QObject*)));
+
+	m_queue.append(reply);
+
+	startRequests();
+
+	return reply;
+}
+
+QString NetworkScheduler::getHost(const QNetworkRequest &request)
+{
+	return request.url().host();
+}
+
+int NetworkScheduler::getPriority(DeferredNetworkReply *reply)
+{
+	return (reply->getPriority() + (isBackground(reply->getWidget()) ? (PrefetchPriority + 1) : 0));
+}
+
+bool NetworkScheduler::isBackground(QWidget *widget)
+{
+	if (!widget || m_currentWindows.isEmpty())
+	{
+		return false;
+	}
+
+	QHash<QObject*, QPointer<QWidget> >::const_iterator iterator;
+
+	for (iterator = m_currentWindows.constBegin(); iterator != m_currentWindows.constEnd(); ++iterator)
+	{
+		if (iterator.value() && (iterator.value() == widget || iterator.value()->isAncestorOf(widget)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+}
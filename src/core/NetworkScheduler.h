@@ -0,0 +1,77 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKSCHEDULER_H
+#define OTTER_NETWORKSCHEDULER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtWidgets/QWidget>
+
+namespace Otter
+{
+
+class DeferredNetworkReply;
+
+class NetworkScheduler : public QObject
+{
+	Q_OBJECT
+	Q_ENUMS(RequestPriority)
+
+public:
+	enum RequestPriority
+	{
+		DocumentPriority = 0,
+		ScriptPriority = 1,
+		FontPriority = 2,
+		ImagePriority = 3,
+		PrefetchPriority = 4
+	};
+
+	static void createInstance(QObject *parent = NULL);
+	static void setCurrentWindow(QObject *windowsManager, QWidget *window);
+	static NetworkScheduler* getInstance();
+	static QNetworkReply* createRequest(QNetworkAccessManager *transportManager, QNetworkAccessManager::Operation operation, const QNetworkRequest &request, RequestPriority priority, QWidget *widget, QObject *parent = NULL);
+	static bool isBackground(QWidget *widget);
+
+protected:
+	explicit NetworkScheduler(QObject *parent = NULL);
+
+	static void startRequests();
+	static QString getHost(const QNetworkRequest &request);
+	static int getPriority(DeferredNetworkReply *reply);
+
+protected slots:
+	void requestFinished();
+	void requestDestroyed(QObject *object);
+	void removeWindowsManager(QObject *windowsManager);
+
+private:
+	static NetworkScheduler *m_instance;
+	static QList<QPointer<DeferredNetworkReply> > m_queue;
+	static QHash<QObject*, QString> m_activeRequests;
+	static QHash<QString, int> m_hostRequests;
+	static QHash<QObject*, QPointer<QWidget> > m_currentWindows;
+};
+
+}
+
+#endif
@@ -0,0 +1,255 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#include "PageLoadBenchmark.h"
+#include "NetworkManagerFactory.h"
+#include "NetworkMemoryCache.h"
+#include "PageSnapshotServer.h"
+#include "TimersManager.h"
+#include "WebBackend.h"
+#include "WebBackendsManager.h"
+#include "../ui/WebWidget.h"
+
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkProxy>
+
+namespace Otter
+{
+
+PageLoadBenchmark::PageLoadBenchmark(QObject *parent) : QObject(parent),
+	m_time(0),
+	m_isLoading(false)
+{
+}
+
+int PageLoadBenchmark::run(const QString &urlsPath, const QString &reportPath, const QString &snapshotsPath, int iterations)
+{
+	QFile urlsFile(urlsPath);
+
+	if (!urlsFile.open(QIODevice::ReadOnly | QIODevice::Text) || !WebBackendsManager::getBackend())
+	{
+		return 1;
+	}
+
+	QList<QUrl> urls;
+	QTextStream stream(&urlsFile);
+
+	while (!stream.atEnd())
+	{
+		const QString line = stream.readLine().trimmed();
+
+		if (!line.isEmpty() && !line.startsWith(QLatin1Char('#')))
+		{
+			urls.append(QUrl::fromUserInput(line).adjusted(QUrl::RemoveFragment));
+		}
+	}
+
+	urlsFile.close();
+
+	PageSnapshotServer *server = NULL;
+	QNetworkAccessManager *transportManager = NetworkManagerFactory::getTransportManager(true);
+
+	if (!snapshotsPath.isEmpty())
+	{
+		server = new PageSnapshotServer(snapshotsPath);
+
+		if (!server->listen(QHostAddress::LocalHost))
+		{
+			delete server;
+
+			return 1;
+		}
+
+		transportManager->setProxy(QNetworkProxy(QNetworkProxy::HttpProxy, QLatin1String("127.0.0.1"), server->serverPort()));
+	}
+
+	PageLoadBenchmark benchmark;
+	QJsonArray results;
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		results.append(benchmark.measureUrl(urls.at(i), qMax(1, iterations)));
+	}
+
+	if (server)
+	{
+		transportManager->setProxy(QNetworkProxy());
+
+		delete server;
+	}
+
+	QJsonObject report;
+	report.insert(QLatin1String("date"), QDateTime::currentDateTime().toString(Qt::ISODate));
+	report.insert(QLatin1String("backend"), WebBackendsManager::getBackend()->getTitle());
+	report.insert(QLatin1String("iterations"), qMax(1, iterations));
+	report.insert(QLatin1String("snapshots"), !snapshotsPath.isEmpty());
+	report.insert(QLatin1String("peakMemoryUsage"), getPeakMemoryUsage());
+	report.insert(QLatin1String("timerWakeups"), TimersManager::getWakeups());
+	report.insert(QLatin1String("timerTasks"), TimersManager::getDispatchedTasks());
+	report.insert(QLatin1String("results"), results);
+
+	const QByteArray data = QJsonDocument(report).toJson();
+
+	if (reportPath.isEmpty() || reportPath == QLatin1String("-"))
+	{
+		QTextStream(stdout) << data;
+
+		return 0;
+	}
+
+	QFile file(reportPath);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return 1;
+	}
+
+	file.write(data);
+	file.close();
+
+	return 0;
+}
+
+void PageLoadBenchmark::updateStatistics()
+{
+	WebWidget *widget = qobject_cast<WebWidget*>(sender());
+
+	if (widget && m_isLoading)
+	{
+		m_statistics = widget->getStatistics();
+	}
+}
+
+void PageLoadBenchmark::updateLoading(bool isLoading)
+{
+	if (!isLoading && m_isLoading)
+	{
+		m_time = m_timer.elapsed();
+		m_isLoading = false;
+
+		emit loadFinished();
+	}
+}
+
+QJsonObject PageLoadBenchmark::measureUrl(const QUrl &url, int iterations)
+{
+	QJsonArray cold;
+	QJsonArray warm;
+
+	for (int i = 0; i < iterations; ++i)
+	{
+		WebWidget *widget = WebBackendsManager::getBackend()->createWidget(true);
+
+		connect(widget, SIGNAL(loadStatusChanged(int,int,qint64,qint64,qint64)), this, SLOT(updateStatistics()));
+		connect(widget, SIGNAL(loadingChanged(bool)), this, SLOT(updateLoading(bool)));
+
+		WebBackendsManager::getBackend()->clearCaches();
+		NetworkManagerFactory::getPrivateCache()->clear();
+		NetworkManagerFactory::getTransportManager(true)->clearAccessCache();
+
+		cold.append(loadUrl(widget, url));
+		warm.append(loadUrl(widget, url));
+
+		delete widget;
+	}
+
+	QJsonObject result;
+	result.insert(QLatin1String("url"), url.toString());
+	result.insert(QLatin1String("cold"), cold);
+	result.insert(QLatin1String("warm"), warm);
+	result.insert(QLatin1String("peakMemoryUsage"), getPeakMemoryUsage());
+
+	return result;
+}
+
+QJsonObject PageLoadBenchmark::loadUrl(WebWidget *widget, const QUrl &url)
+{
+	QEventLoop eventLoop;
+	QTimer timeoutTimer;
+	timeoutTimer.setSingleShot(true);
+
+	connect(this, SIGNAL(loadFinished()), &eventLoop, SLOT(quit()));
+	connect(&timeoutTimer, SIGNAL(timeout()), &eventLoop, SLOT(quit()));
+
+	m_statistics.clear();
+	m_time = 0;
+	m_isLoading = true;
+	m_timer.start();
+
+	timeoutTimer.start(60000);
+
+	widget->setUrl(url, false);
+
+	if (m_isLoading)
+	{
+		eventLoop.exec();
+	}
+
+	const bool hasTimedOut = m_isLoading;
+
+	if (hasTimedOut)
+	{
+		m_time = m_timer.elapsed();
+		m_isLoading = false;
+
+		widget->triggerAction(StopAction);
+	}
+
+	QJsonObject result;
+	result.insert(QLatin1String("time"), m_time);
+	result.insert(QLatin1String("timedOut"), hasTimedOut);
+	result.insert(QLatin1String("startedRequests"), m_statistics.value(QLatin1String("startedRequests")).toInt());
+	result.insert(QLatin1String("finishedRequests"), m_statistics.value(QLatin1String("finishedRequests")).toInt());
+	result.insert(QLatin1String("multiplexedRequests"), m_statistics.value(QLatin1String("multiplexedRequests")).toInt());
+	result.insert(QLatin1String("blockedRequests"), m_statistics.value(QLatin1String("blockedRequests")).toInt());
+	result.insert(QLatin1String("bytesReceived"), m_statistics.value(QLatin1String("bytesReceived")).toLongLong());
+
+	return result;
+}
+
+qint64 PageLoadBenchmark::getPeakMemoryUsage()
+{
+	QFile file(QLatin1String("/proc/self/status"));
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return -1;
+	}
+
+	while (!file.atEnd())
+	{
+		const QString line = QString(file.readLine());
+
+		if (line.startsWith(QLatin1String("VmHWM:")))
+		{
+			return (line.section(QLatin1Char(' '), 1, -1, QString::SectionSkipEmpty).section(QLatin1Char(' '), 0, 0).toLongLong() * 1024);
+		}
+	}
+
+	return -1;
+}
+
+}
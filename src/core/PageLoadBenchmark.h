@@ -0,0 +1,65 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#ifndef OTTER_PAGELOADBENCHMARK_H
+#define OTTER_PAGELOADBENCHMARK_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QUrl>
+#include <QtCore/QVariantHash>
+
+namespace Otter
+{
+
+class WebWidget;
+
+class PageLoadBenchmark : public QObject
+{
+	Q_OBJECT
+
+public:
+	static int run(const QString &urlsPath, const QString &reportPath, const QString &snapshotsPath, int iterations);
+
+protected:
+	explicit PageLoadBenchmark(QObject *parent = NULL);
+
+	QJsonObject measureUrl(const QUrl &url, int iterations);
+	QJsonObject loadUrl(WebWidget *widget, const QUrl &url);
+	static qint64 getPeakMemoryUsage();
+
+protected slots:
+	void updateStatistics();
+	void updateLoading(bool isLoading);
+
+private:
+	QElapsedTimer m_timer;
+	QVariantHash m_statistics;
+	qint64 m_time;
+	bool m_isLoading;
+
+signals:
+	void loadFinished();
+};
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#include "PageSnapshotServer.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMimeDatabase>
+
+namespace Otter
+{
+
+PageSnapshotServer::PageSnapshotServer(const QString &path, QObject *parent) : QTcpServer(parent),
+	m_path(QDir(path).absolutePath())
+{
+	connect(this, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+}
+
+void PageSnapshotServer::acceptConnection()
+{
+	while (hasPendingConnections())
+	{
+		QTcpSocket *socket = nextPendingConnection();
+
+		connect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+		connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+	}
+}
+
+void PageSnapshotServer::readRequest()
+{
+	QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+
+	if (!socket || !socket->peek(socket->bytesAvailable()).contains("\r\n\r\n"))
+	{
+		return;
+	}
+
+	const QList<QByteArray> requestLine = socket->readLine().trimmed().split(' ');
+	QByteArray host;
+
+	while (socket->canReadLine())
+	{
+		const QByteArray line = socket->readLine().trimmed();
+
+		if (line.isEmpty())
+		{
+			break;
+		}
+
+		if (line.toLower().startsWith("host:"))
+		{
+			host = line.mid(5).trimmed();
+		}
+	}
+
+	disconnect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+
+	if (requestLine.count() < 2 || (requestLine.at(0) != "GET" && requestLine.at(0) != "HEAD"))
+	{
+		sendResponse(socket, 501, "Not Implemented");
+
+		return;
+	}
+
+	QUrl url(QString::fromLatin1(requestLine.at(1)));
+
+	if (url.isRelative())
+	{
+		url = QUrl(QLatin1String("http://") + QString::fromLatin1(host) + QString::fromLatin1(requestLine.at(1)));
+	}
+
+	const QString path = getSnapshotPath(url);
+
+	if (path.isEmpty())
+	{
+		sendResponse(socket, 404, "Not Found", "text/plain", "Not Found", (requestLine.at(0) == "GET"));
+
+		return;
+	}
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		sendResponse(socket, 403, "Forbidden", "text/plain", "Forbidden", (requestLine.at(0) == "GET"));
+
+		return;
+	}
+
+	sendResponse(socket, 200, "OK", QMimeDatabase().mimeTypeForFile(path).name().toLatin1(), file.readAll(), (requestLine.at(0) == "GET"));
+}
+
+void PageSnapshotServer::sendResponse(QTcpSocket *socket, int status, const QByteArray &reason, const QByteArray &contentType, const QByteArray &body, bool sendBody)
+{
+	QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reason + "\r\n";
+
+	if (!contentType.isEmpty())
+	{
+		response.append("Content-Type: " + contentType + "\r\n");
+	}
+
+	response.append("Content-Length: " + QByteArray::number(body.size()) + "\r\n");
+	response.append("Cache-Control: max-age=3600\r\n");
+	response.append("Connection: close\r\n\r\n");
+
+	if (sendBody)
+	{
+		response.append(body);
+	}
+
+	socket->write(response);
+	socket->disconnectFromHost();
+}
+
+QString PageSnapshotServer::getSnapshotPath(const QUrl &url) const
+{
+	QString path = url.path();
+
+	if (path.isEmpty() || path.endsWith(QLatin1Char('/')))
+	{
+		path.append(QLatin1String("index.html"));
+	}
+
+	const QStringList candidates = QStringList() << (url.host().toLower() + path) << path.mid(1);
+
+	for (int i = 0; i < candidates.count(); ++i)
+	{
+		const QFileInfo information(QDir(m_path).filePath(candidates.at(i)));
+
+		if (information.isFile() && information.absoluteFilePath().startsWith(m_path + QLatin1Char('/')))
+		{
+			return information.absoluteFilePath();
+		}
+	}
+
+	return QString();
+}
+
+}
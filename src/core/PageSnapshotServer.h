@@ -0,0 +1,53 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#ifndef OTTER_PAGESNAPSHOTSERVER_H
+#define OTTER_PAGESNAPSHOTSERVER_H
+
+#include <QtCore/QUrl>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+namespace Otter
+{
+
+class PageSnapshotServer : public QTcpServer
+{
+	Q_OBJECT
+
+public:
+	explicit PageSnapshotServer(const QString &path, QObject *parent = NULL);
+
+	QString getSnapshotPath(const QUrl &url) const;
+
+protected:
+	void sendResponse(QTcpSocket *socket, int status, const QByteArray &reason, const QByteArray &contentType = QByteArray(), const QByteArray &body = QByteArray(), bool sendBody = true);
+
+protected slots:
+	void acceptConnection();
+	void readRequest();
+
+private:
+	QString m_path;
+};
+
+}
+
+#endif
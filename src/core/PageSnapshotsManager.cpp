@@ -0,0 +1,372 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#include "PageSnapshotsManager.h"
+#include "NetworkCache.h"
+#include "NetworkManagerFactory.h"
+#include "SessionsManager.h"
+#include "SettingsManager.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMap>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThreadPool>
+#include <QtNetwork/QNetworkDiskCache>
+
+namespace Otter
+{
+
+PageSnapshotsManager* PageSnapshotsManager::m_instance = NULL;
+QCache<QString, PageSnapshot> PageSnapshotsManager::m_snapshots(16777216);
+QHash<QString, QDateTime> PageSnapshotsManager::m_snapshotFiles;
+QSet<QString> PageSnapshotsManager::m_sessionSnapshots;
+int PageSnapshotsManager::m_snapshotsLimit = 50;
+bool PageSnapshotsManager::m_isLoaded = false;
+
+PageSnapshotTask::PageSnapshotTask(const QUrl &url, const QList<QUrl> &resources, const QString &cachePath, const QString &path) : QRunnable(),
+	m_url(url),
+	m_resources(resources),
+	m_cachePath(cachePath),
+	m_path(path)
+{
+}
+
+void PageSnapshotTask::run()
+{
+	QNetworkDiskCache cache;
+	cache.setCacheDirectory(m_cachePath);
+
+	const QString key = m_url.adjusted(QUrl::RemoveFragment).toString();
+	QHash<QString, PageSnapshotResource> resources;
+
+	for (int i = 0; i < m_resources.count(); ++i)
+	{
+		QIODevice *device = cache.data(m_resources.at(i));
+
+		if (!device)
+		{
+			continue;
+		}
+
+		const QNetworkCacheMetaData metaData = cache.metaData(m_resources.at(i));
+		const QByteArray rawData = device->readAll();
+
+		delete device;
+
+		PageSnapshotResource resource;
+		resource.headers = metaData.rawHeaders();
+		resource.data = NetworkCache::decompressData(metaData, rawData);
+
+		if (resource.data.isEmpty() && !rawData.isEmpty())
+		{
+			continue;
+		}
+
+		resources[m_resources.at(i).adjusted(QUrl::RemoveFragment).toString()] = resource;
+	}
+
+	if (!resources.contains(key))
+	{
+		return;
+	}
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream << m_url << static_cast<qint32>(resources.count());
+
+	QHash<QString, PageSnapshotResource>::const_iterator iterator;
+
+	for (iterator = resources.constBegin(); iterator != resources.constEnd(); ++iterator)
+	{
+		stream << iterator.key() << static_cast<qint32>(iterator.value().headers.count());
+
+		for (int i = 0; i < iterator.value().headers.count(); ++i)
+		{
+			stream << iterator.value().headers.at(i).first << iterator.value().headers.at(i).second;
+		}
+
+		stream << iterator.value().data;
+	}
+
+	QDir().mkpath(QFileInfo(m_path).absolutePath());
+
+	QSaveFile file(m_path);
+
+	if (file.open(QIODevice::WriteOnly))
+	{
+		file.write(qCompress(data));
+
+		if (file.commit())
+		{
+			QMetaObject::invokeMethod(PageSnapshotsManager::getInstance(), "taskFinished", Qt::QueuedConnection, Q_ARG(QString, m_path));
+		}
+	}
+}
+
+PageSnapshotsManager::PageSnapshotsManager(QObject *parent) : QObject(parent)
+{
+	optionChanged(QLatin1String("Cache/PageSnapshotsLimit"), SettingsManager::getValue(QLatin1String("Cache/PageSnapshotsLimit")));
+
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+}
+
+void PageSnapshotsManager::createInstance(QObject *parent)
+{
+	if (!m_instance)
+	{
+		m_instance = new PageSnapshotsManager(parent);
+	}
+}
+
+void PageSnapshotsManager::optionChanged(const QString &option, const QVariant &value)
+{
+	if (option == QLatin1String("Cache/PageSnapshotsLimit"))
+	{
+		m_snapshotsLimit = value.toInt();
+
+		if (m_isLoaded)
+		{
+			removeExcessSnapshots();
+		}
+	}
+}
+
+void PageSnapshotsManager::taskFinished(const QString &path)
+{
+	const QString fileName = QFileInfo(path).fileName();
+
+	m_snapshotFiles[fileName] = QDateTime::currentDateTime();
+	m_sessionSnapshots.insert(fileName);
+
+	removeExcessSnapshots();
+}
+
+void PageSnapshotsManager::storeSnapshot(const QUrl &url, const QList<QUrl> &resources)
+{
+	NetworkCache *cache = NetworkManagerFactory::getCache();
+	const QString path = getSnapshotPath(url);
+
+	if (!m_instance || m_snapshotsLimit <= 0 || !cache || cache->cacheDirectory().isEmpty() || path.isEmpty() || resources.isEmpty())
+	{
+		return;
+	}
+
+	loadSnapshots();
+
+	m_snapshots.remove(getKey(url));
+
+	QThreadPool::globalInstance()->start(new PageSnapshotTask(url, resources, cache->cacheDirectory(), path));
+}
+
+void PageSnapshotsManager::clearSnapshots(int period)
+{
+	loadSnapshots();
+
+	m_snapshots.clear();
+
+	const QDir directory(SessionsManager::getCachePath() + QLatin1String("/snapshots/"));
+	const QDateTime date = QDateTime::currentDateTime().addSecs(period * -3600);
+	QHash<QString, QDateTime>::iterator iterator = m_snapshotFiles.begin();
+
+	while (iterator != m_snapshotFiles.end())
+	{
+		if (period <= 0 || iterator.value() >= date)
+		{
+			QFile::remove(directory.absoluteFilePath(iterator.key()));
+
+			m_sessionSnapshots.remove(iterator.key());
+
+			iterator = m_snapshotFiles.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+}
+
+void PageSnapshotsManager::loadSnapshots()
+{
+	if (m_isLoaded || SessionsManager::getCachePath().isEmpty())
+	{
+		return;
+	}
+
+	m_isLoaded = true;
+
+	const QFileInfoList files = QDir(SessionsManager::getCachePath() + QLatin1String("/snapshots/")).entryInfoList(QStringList(QLatin1String("*.snapshot")), QDir::Files);
+
+	for (int i = 0; i < files.count(); ++i)
+	{
+		m_snapshotFiles[files.at(i).fileName()] = files.at(i).lastModified();
+	}
+
+	removeExcessSnapshots();
+}
+
+void PageSnapshotsManager::removeExcessSnapshots()
+{
+	if (m_snapshotFiles.count() <= qMax(0, m_snapshotsLimit))
+	{
+		return;
+	}
+
+	QMultiMap<QDateTime, QString> files;
+	QHash<QString, QDateTime>::const_iterator iterator;
+
+	for (iterator = m_snapshotFiles.constBegin(); iterator != m_snapshotFiles.constEnd(); ++iterator)
+	{
+		if (!m_sessionSnapshots.contains(iterator.key()))
+		{
+			files.insert(iterator.value(), iterator.key());
+		}
+	}
+
+	const QDir directory(SessionsManager::getCachePath() + QLatin1String("/snapshots/"));
+	QMultiMap<QDateTime, QString>::const_iterator filesIterator;
+
+	for (filesIterator = files.constBegin(); (filesIterator != files.constEnd() && m_snapshotFiles.count() > qMax(0, m_snapshotsLimit)); ++filesIterator)
+	{
+		m_snapshotFiles.remove(filesIterator.value());
+
+		QFile::remove(directory.absoluteFilePath(filesIterator.value()));
+	}
+}
+
+PageSnapshotsManager* PageSnapshotsManager::getInstance()
+{
+	return m_instance;
+}
+
+QString PageSnapshotsManager::getSnapshotPath(const QUrl &url)
+{
+	if (SessionsManager::getCachePath().isEmpty())
+	{
+		return QString();
+	}
+
+	return (SessionsManager::getCachePath() + QLatin1String("/snapshots/") + QString(QCryptographicHash::hash(getKey(url).toUtf8(), QCryptographicHash::Sha1).toHex()) + QLatin1String(".snapshot"));
+}
+
+QString PageSnapshotsManager::getKey(const QUrl &url)
+{
+	return url.adjusted(QUrl::RemoveFragment).toString();
+}
+
+PageSnapshot PageSnapshotsManager::getSnapshot(const QUrl &url)
+{
+	const QString key = getKey(url);
+
+	if (m_snapshots.contains(key))
+	{
+		return *m_snapshots.object(key);
+	}
+
+	PageSnapshot snapshot;
+
+	if (!hasSnapshot(url))
+	{
+		return snapshot;
+	}
+
+	QFile file(getSnapshotPath(url));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return snapshot;
+	}
+
+	const QByteArray data = qUncompress(file.readAll());
+	QDataStream stream(data);
+	qint32 amount = 0;
+	int size = 0;
+
+	stream >> snapshot.url >> amount;
+
+	for (qint32 i = 0; (i < amount && stream.status() == QDataStream::Ok); ++i)
+	{
+		QString resourceKey;
+		qint32 headersAmount = 0;
+		PageSnapshotResource resource;
+
+		stream >> resourceKey >> headersAmount;
+
+		for (qint32 j = 0; (j < headersAmount && stream.status() == QDataStream::Ok); ++j)
+		{
+			QByteArray name;
+			QByteArray value;
+
+			stream >> name >> value;
+
+			resource.headers.append(qMakePair(name, value));
+		}
+
+		stream >> resource.data;
+
+		size += resource.data.size();
+
+		snapshot.resources[resourceKey] = resource;
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		return PageSnapshot();
+	}
+
+	m_snapshots.insert(key, new PageSnapshot(snapshot), qMax(1, size));
+	m_sessionSnapshots.insert(QFileInfo(file).fileName());
+
+	return snapshot;
+}
+
+QDateTime PageSnapshotsManager::getSnapshotTime(const QUrl &url)
+{
+	if (m_snapshotsLimit <= 0)
+	{
+		return QDateTime();
+	}
+
+	loadSnapshots();
+
+	return m_snapshotFiles.value(QFileInfo(getSnapshotPath(url)).fileName());
+}
+
+bool PageSnapshotsManager::hasSnapshot(const QUrl &url)
+{
+	if (m_snapshotsLimit <= 0)
+	{
+		return false;
+	}
+
+	if (m_snapshots.contains(getKey(url)))
+	{
+		return true;
+	}
+
+	loadSnapshots();
+
+	return m_snapshotFiles.contains(QFileInfo(getSnapshotPath(url)).fileName());
+}
+
+}
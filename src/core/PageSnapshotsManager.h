@@ -0,0 +1,97 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#ifndef OTTER_PAGESNAPSHOTSMANAGER_H
+#define OTTER_PAGESNAPSHOTSMANAGER_H
+
+#include <QtCore/QCache>
+#include <QtCore/QDateTime>
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QSet>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkReply>
+
+namespace Otter
+{
+
+struct PageSnapshotResource
+{
+	QList<QNetworkReply::RawHeaderPair> headers;
+	QByteArray data;
+};
+
+struct PageSnapshot
+{
+	QUrl url;
+	QHash<QString, PageSnapshotResource> resources;
+};
+
+class PageSnapshotTask : public QRunnable
+{
+public:
+	explicit PageSnapshotTask(const QUrl &url, const QList<QUrl> &resources, const QString &cachePath, const QString &path);
+
+	void run();
+
+private:
+	QUrl m_url;
+	QList<QUrl> m_resources;
+	QString m_cachePath;
+	QString m_path;
+};
+
+class PageSnapshotsManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance(QObject *parent = NULL);
+	static void storeSnapshot(const QUrl &url, const QList<QUrl> &resources);
+	static void clearSnapshots(int period = 0);
+	static PageSnapshotsManager* getInstance();
+	static PageSnapshot getSnapshot(const QUrl &url);
+	static QDateTime getSnapshotTime(const QUrl &url);
+	static bool hasSnapshot(const QUrl &url);
+
+protected:
+	explicit PageSnapshotsManager(QObject *parent = NULL);
+
+	static void loadSnapshots();
+	static void removeExcessSnapshots();
+	static QString getSnapshotPath(const QUrl &url);
+	static QString getKey(const QUrl &url);
+
+protected slots:
+	void optionChanged(const QString &option, const QVariant &value);
+	void taskFinished(const QString &path);
+
+private:
+	static PageSnapshotsManager *m_instance;
+	static QCache<QString, PageSnapshot> m_snapshots;
+	static QHash<QString, QDateTime> m_snapshotFiles;
+	static QSet<QString> m_sessionSnapshots;
+	static int m_snapshotsLimit;
+	static bool m_isLoaded;
+};
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#include "SnapshotNetworkReply.h"
+
+#include <QtCore/QTimer>
+
+namespace Otter
+{
+
+SnapshotNetworkReply::SnapshotNetworkReply(QObject *parent, const QNetworkRequest &request, const PageSnapshotResource &resource) : QNetworkReply(parent),
+	m_content(resource.data),
+	m_offset(0)
+{
+	setRequest(request);
+	setUrl(request.url());
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+	for (int i = 0; i < resource.headers.count(); ++i)
+	{
+		const QByteArray name = resource.headers.at(i).first.toLower();
+
+		if (name != "content-length" && name != "content-encoding" && name != "transfer-encoding")
+		{
+			setRawHeader(resource.headers.at(i).first, resource.headers.at(i).second);
+		}
+	}
+
+	setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+	setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+	setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, QByteArray("OK"));
+	setAttribute(QNetworkRequest::SourceIsFromCacheAttribute, true);
+
+	QTimer::singleShot(0, this, SIGNAL(metaDataChanged()));
+	QTimer::singleShot(0, this, SIGNAL(readyRead()));
+	QTimer::singleShot(0, this, SIGNAL(finished()));
+}
+
+void SnapshotNetworkReply::abort()
+{
+}
+
+qint64 SnapshotNetworkReply::bytesAvailable() const
+{
+	return (m_content.size() - m_offset);
+}
+
+qint64 SnapshotNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (m_offset < m_content.size())
+	{
+		const qint64 number = qMin(maxSize, (m_content.size() - m_offset));
+
+		memcpy(data, (m_content.constData() + m_offset), number);
+
+		m_offset += number;
+
+		return number;
+	}
+
+	return -1;
+}
+
+bool SnapshotNetworkReply::isSequential() const
+{
+	return true;
+}
+
+}
@@ -0,0 +1,199 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#include "TimersManager.h"
+
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+TimersManager* TimersManager::m_instance = NULL;
+QList<TimersManager::TimerTask> TimersManager::m_tasks;
+QElapsedTimer TimersManager::m_clock;
+qint64 TimersManager::m_wakeups = 0;
+qint64 TimersManager::m_dispatchedTasks = 0;
+int TimersManager::m_timer = 0;
+
+TimersManager::TimersManager(QObject *parent) : QObject(parent)
+{
+	m_clock.start();
+}
+
+void TimersManager::createInstance(QObject *parent)
+{
+	if (!m_instance)
+	{
+		m_instance = new TimersManager(parent);
+	}
+}
+
+void TimersManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_timer)
+	{
+		return;
+	}
+
+	killTimer(m_timer);
+
+	m_timer = 0;
+
+	++m_wakeups;
+
+	const qint64 currentTime = m_clock.elapsed();
+	QList<QPair<QPointer<QObject>, QByteArray> > dueTasks;
+
+	for (int i = 0; i < m_tasks.count(); ++i)
+	{
+		if (m_tasks.at(i).deadline <= (currentTime + (m_tasks.at(i).interval / 20)))
+		{
+			dueTasks.append(qMakePair(m_tasks.at(i).object, m_tasks.at(i).method));
+
+			do
+			{
+				m_tasks[i].deadline += m_tasks.at(i).interval;
+			}
+			while (m_tasks.at(i).deadline <= currentTime);
+		}
+	}
+
+	for (int i = 0; i < dueTasks.count(); ++i)
+	{
+		if (dueTasks.at(i).first && hasTask(dueTasks.at(i).first, dueTasks.at(i).second.constData()))
+		{
+			++m_dispatchedTasks;
+
+			QMetaObject::invokeMethod(dueTasks.at(i).first, dueTasks.at(i).second.constData());
+		}
+	}
+
+	scheduleTimer();
+}
+
+void TimersManager::addTask(QObject *object, const char *method, int interval)
+{
+	if (!m_instance || !object || hasTask(object, method))
+	{
+		return;
+	}
+
+	TimerTask task;
+	task.object = object;
+	task.method = QByteArray(method);
+	task.interval = (qMax(250, interval) + 249) / 250 * 250;
+	task.deadline = getDeadline(task.interval);
+
+	m_tasks.append(task);
+
+	connect(object, SIGNAL(destroyed(QObject*)), m_instance, SLOT(removeTasks(QObject*)), Qt::UniqueConnection);
+
+	scheduleTimer();
+}
+
+void TimersManager::removeTask(QObject *object, const char *method)
+{
+	for (int i = (m_tasks.count() - 1); i >= 0; --i)
+	{
+		if (m_tasks.at(i).object == object && m_tasks.at(i).method == method)
+		{
+			m_tasks.removeAt(i);
+		}
+	}
+
+	scheduleTimer();
+}
+
+void TimersManager::removeTasks(QObject *object)
+{
+	for (int i = (m_tasks.count() - 1); i >= 0; --i)
+	{
+		if (!m_tasks.at(i).object || m_tasks.at(i).object == object)
+		{
+			m_tasks.removeAt(i);
+		}
+	}
+
+	scheduleTimer();
+}
+
+void TimersManager::scheduleTimer()
+{
+	if (!m_instance)
+	{
+		return;
+	}
+
+	if (m_timer != 0)
+	{
+		m_instance->killTimer(m_timer);
+
+		m_timer = 0;
+	}
+
+	if (m_tasks.isEmpty())
+	{
+		return;
+	}
+
+	qint64 deadline = m_tasks.at(0).deadline;
+
+	for (int i = 1; i < m_tasks.count(); ++i)
+	{
+		deadline = qMin(deadline, m_tasks.at(i).deadline);
+	}
+
+	m_timer = m_instance->startTimer(static_cast<int>(qMax(qint64(0), (deadline - m_clock.elapsed()))), Qt::CoarseTimer);
+}
+
+TimersManager* TimersManager::getInstance()
+{
+	return m_instance;
+}
+
+qint64 TimersManager::getDeadline(int interval)
+{
+	return (((m_clock.elapsed() / interval) + 1) * interval);
+}
+
+qint64 TimersManager::getWakeups()
+{
+	return m_wakeups;
+}
+
+qint64 TimersManager::getDispatchedTasks()
+{
+	return m_dispatchedTasks;
+}
+
+bool TimersManager::hasTask(QObject *object, const char *method)
+{
+	for (int i = 0; i < m_tasks.count(); ++i)
+	{
+		if (m_tasks.at(i).object == object && m_tasks.at(i).method == method)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
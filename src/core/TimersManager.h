@@ -0,0 +1,73 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#ifndef OTTER_TIMERSMANAGER_H
+#define OTTER_TIMERSMANAGER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+
+namespace Otter
+{
+
+class TimersManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance(QObject *parent = NULL);
+	static void addTask(QObject *object, const char *method, int interval);
+	static void removeTask(QObject *object, const char *method);
+	static TimersManager* getInstance();
+	static qint64 getWakeups();
+	static qint64 getDispatchedTasks();
+	static bool hasTask(QObject *object, const char *method);
+
+protected:
+	struct TimerTask
+	{
+		QPointer<QObject> object;
+		QByteArray method;
+		qint64 deadline;
+		int interval;
+	};
+
+	explicit TimersManager(QObject *parent = NULL);
+
+	void timerEvent(QTimerEvent *event);
+	static void scheduleTimer();
+	static qint64 getDeadline(int interval);
+
+protected slots:
+	void removeTasks(QObject *object);
+
+private:
+	static TimersManager *m_instance;
+	static QList<TimerTask> m_tasks;
+	static QElapsedTimer m_clock;
+	static qint64 m_wakeups;
+	static qint64 m_dispatchedTasks;
+	static int m_timer;
+};
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "NetworkManager.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
+#include "TimersManager.h"
 #include "WebBackend.h"
 #include "WebBackendsManager.h"
 #include "../ui/MainWindow.h"
@@ -42,8 +43,7 @@ NetworkManager* TransfersManager::m_networkManager = NULL;
 QHash<QNetworkReply*, TransferInformation*> TransfersManager::m_replies;
 QList<TransferInformation*> TransfersManager::m_transfers;
 
-TransfersManager::TransfersManager(QObject *parent) : QObject(parent),
-	m_updateTimer(0)
+TransfersManager::TransfersManager(QObject *parent) : QObject(parent)
 {
 	QSettings history(SessionsManager::getProfilePath() + QLatin1String("/transfers.ini"), QSettings::IniFormat);
 	const QStringList entries = history.childGroups();
@@ -82,10 +82,8 @@ void TransfersManager::createInstance(QObject *parent)
 	}
 }
 
-void TransfersManager::timerEvent(QTimerEvent *event)
+void TransfersManager::updateTransfers()
 {
-	Q_UNUSED(event)
-
 	QHash<QNetworkReply*, TransferInformation*>::iterator iterator;
 
 	for (iterator = m_replies.begin(); iterator != m_replies.end(); ++iterator)
@@ -103,18 +101,13 @@ void TransfersManager::timerEvent(QTimerEvent *event)
 
 	if (m_replies.isEmpty())
 	{
-		killTimer(m_updateTimer);
-
-		m_updateTimer = 0;
+		TimersManager::removeTask(this, "updateTransfers");
 	}
 }
 
 void TransfersManager::startUpdates()
 {
-	if (m_updateTimer == 0)
-	{
-		m_updateTimer = startTimer(500);
-	}
+	TimersManager::addTask(this, "updateTransfers", 500);
 }
 
 void TransfersManager::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
@@ -83,7 +83,6 @@ public:
 protected:
 	explicit TransfersManager(QObject *parent = NULL);
 
-	void timerEvent(QTimerEvent *event);
 	void startUpdates();
 
 protected slots:
@@ -91,11 +90,10 @@ protected slots:
 	void downloadData(QNetworkReply *reply = NULL);
 	void downloadFinished(QNetworkReply *reply = NULL);
 	void downloadError(QNetworkReply::NetworkError error);
+	void updateTransfers();
 	void save();
 
 private:
-	int m_updateTimer;
-
 	static TransfersManager *m_instance;
 	static NetworkManager *m_networkManager;
 	static QHash<QNetworkReply*, TransferInformation*> m_replies;
@@ -37,6 +37,7 @@ class WebBackend : public QObject
 public:
 	explicit WebBackend(QObject *parent = NULL);
 
+	virtual void clearCaches() = 0;
 	virtual WebWidget* createWidget(bool isPrivate = false, ContentsWidget *parent = NULL) = 0;
 	virtual QString getTitle() const = 0;
 	virtual QString getDescription() const = 0;
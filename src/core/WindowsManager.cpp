@@ -21,6 +21,7 @@
 #include "WindowsManager.h"
 #include "Application.h"
 #include "BookmarksModel.h"
+#include "NetworkScheduler.h"
 #include "SettingsManager.h"
 #include "../ui/ContentsWidget.h"
 #include "../ui/MainWindow.h"
@@ -689,6 +690,8 @@ void WindowsManager::setActiveWindow(int index)
 
 	ActionsManager::getAction(QLatin1String("CloneTab"), m_mdi)->setEnabled(window && window->canClone());
 
+	NetworkScheduler::setCurrentWindow(this, window);
+
 	emit actionsChanged();
 	emit currentWindowChanged(index);
 }
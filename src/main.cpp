@@ -18,6 +18,8 @@
 **************************************************************************/
 
 #include "core/Application.h"
+#include "core/HistoryBenchmark.h"
+#include "core/PageLoadBenchmark.h"
 #include "core/SessionsManager.h"
 #include "core/SettingsManager.h"
 #include "ui/MainWindow.h"
@@ -61,14 +63,55 @@ int main(int argc, char *argv[])
 	qInstallMessageHandler(otterMessageHander);
 
 	Application application(argc, argv);
+	QCommandLineParser *parser = application.getParser();
+	parser->process(application);
 
 	if (application.isRunning())
 	{
+		const bool isBenchmark = (parser->isSet(QLatin1String("benchmark-history")) || parser->isSet(QLatin1String("benchmark-pages")));
+
+		delete parser;
+
+		if (isBenchmark)
+		{
+			fprintf(stderr, "%s\n", QCoreApplication::translate("main", "Benchmarks cannot be run while another instance is using this profile, close it or use --profile to select another one.").toLocal8Bit().constData());
+
+			return 1;
+		}
+
 		return 0;
 	}
 
-	QCommandLineParser *parser = application.getParser();
-	parser->process(application);
+	if (parser->isSet(QLatin1String("benchmark-history")))
+	{
+		const QStringList values = parser->value(QLatin1String("benchmark-history-sizes")).split(QLatin1Char(','), QString::SkipEmptyParts);
+		QList<int> sizes;
+
+		for (int i = 0; i < values.count(); ++i)
+		{
+			const int size = values.at(i).trimmed().toInt();
+
+			if (size > 0)
+			{
+				sizes.append(size);
+			}
+		}
+
+		const int result = HistoryBenchmark::run(parser->value(QLatin1String("benchmark-history")), sizes);
+
+		delete parser;
+
+		return result;
+	}
+
+	if (parser->isSet(QLatin1String("benchmark-pages")))
+	{
+		const int result = PageLoadBenchmark::run(parser->value(QLatin1String("benchmark-pages")), parser->value(QLatin1String("benchmark-pages-report")), parser->value(QLatin1String("benchmark-pages-snapshots")), parser->value(QLatin1String("benchmark-pages-iterations")).toInt());
+
+		delete parser;
+
+		return result;
+	}
 
 	const QString session = (parser->value(QLatin1String("session")).isEmpty() ? QLatin1String("default") : parser->value(QLatin1String("session")));
 	const QString startupBehavior = SettingsManager::getValue(QLatin1String("Browser/StartupBehavior")).toString();
@@ -23,42 +23,54 @@
 #include "../../../../core/ContentBlockingManager.h"
 #include "../../../../core/Console.h"
 #include "../../../../core/CookieJar.h"
+#include "../../../../core/DeferredNetworkReply.h"
 #include "../../../../core/LocalListingNetworkReply.h"
 #include "../../../../core/NetworkManagerFactory.h"
+#include "../../../../core/NetworkMemoryCache.h"
+#include "../../../../core/PageSnapshotsManager.h"
 #include "../../../../core/SettingsManager.h"
+#include "../../../../core/SnapshotNetworkReply.h"
+#include "../../../../core/TimersManager.h"
 #include "../../../../core/Utils.h"
 #include "../../../../ui/AuthenticationDialog.h"
 #include "../../../../ui/ContentsDialog.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QUrlQuery>
+#include <QtNetwork/QNetworkCookieJar>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QNetworkReply>
+#include <QtWebKitWidgets/QWebFrame>
+#include <QtWebKitWidgets/QWebPage>
 
 namespace Otter
 {
 
 QtWebKitNetworkManager::QtWebKitNetworkManager(bool isPrivate, QtWebKitWebWidget *widget) : NetworkManager(isPrivate, widget),
 	m_widget(widget),
+	m_transportManager(NetworkManagerFactory::getTransportManager(isPrivate)),
 	m_baseReply(NULL),
 	m_speed(0),
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
+	m_blockedRequests(0),
 	m_finishedRequests(0),
+	m_multiplexedRequests(0),
 	m_startedRequests(0),
-	m_updateTimer(0),
 	m_doNotTrackPolicy(NetworkManagerFactory::SkipTrackPolicy),
-	m_canSendReferrer(true)
+	m_canSendReferrer(true),
+	m_isPrivate(isPrivate)
 {
-	connect(this, SIGNAL(finished(QNetworkReply*)), SLOT(requestFinished(QNetworkReply*)));
-}
-
-void QtWebKitNetworkManager::timerEvent(QTimerEvent *event)
-{
-	Q_UNUSED(event)
+	if (isPrivate)
+	{
+		NetworkManagerFactory::getPrivateCache()->addManager(this);
+	}
 
-	updateStatus();
+	connect(this, SIGNAL(finished(QNetworkReply*)), SLOT(requestFinished(QNetworkReply*)));
+	connect(m_transportManager, SIGNAL(authenticationRequired(QNetworkReply*,QAuthenticator*)), this, SLOT(handleTransportAuthenticationRequired(QNetworkReply*,QAuthenticator*)));
 }
 
 void QtWebKitNetworkManager::handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
@@ -83,6 +95,21 @@ void QtWebKitNetworkManager::handleAuthenticationRequired(QNetworkReply *reply,
 	m_widget->hideDialog(&dialog);
 }
 
+void QtWebKitNetworkManager::handleTransportAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
+{
+	DeferredNetworkReply *deferredReply = qobject_cast<DeferredNetworkReply*>(reply->parent());
+
+	if (deferredReply)
+	{
+		reply = deferredReply;
+	}
+
+	if (reply->manager() == this)
+	{
+		handleAuthenticationRequired(reply, authenticator);
+	}
+}
+
 void QtWebKitNetworkManager::handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator)
 {
 	if (NetworkManagerFactory::isUsingSystemProxyAuthentication())
@@ -192,17 +219,19 @@ void QtWebKitNetworkManager::handleSslErrors(QNetworkReply *reply, const QList<Q
 
 void QtWebKitNetworkManager::resetStatistics()
 {
-	killTimer(m_updateTimer);
+	TimersManager::removeTask(this, "updateStatus");
+
 	updateStatus();
 
-	m_updateTimer = 0;
 	m_replies.clear();
 	m_baseReply = NULL;
 	m_speed = 0;
 	m_bytesReceivedDifference = 0;
 	m_bytesReceived = 0;
 	m_bytesTotal = 0;
+	m_blockedRequests = 0;
 	m_finishedRequests = 0;
+	m_multiplexedRequests = 0;
 	m_startedRequests = 0;
 }
 
@@ -229,6 +258,11 @@ void QtWebKitNetworkManager::downloadProgress(qint64 bytesReceived, qint64 bytes
 		}
 	}
 
+	if (reply && m_pendingRequests.contains(reply))
+	{
+		m_pendingRequests[reply].bytesReceived = bytesReceived;
+	}
+
 	if (!reply || !m_replies.contains(reply))
 	{
 		return;
@@ -260,9 +294,7 @@ void QtWebKitNetworkManager::requestFinished(QNetworkReply *reply)
 
 	if (m_replies.isEmpty())
 	{
-		killTimer(m_updateTimer);
-
-		m_updateTimer = 0;
+		TimersManager::removeTask(this, "updateStatus");
 
 		updateStatus();
 	}
@@ -272,6 +304,79 @@ void QtWebKitNetworkManager::requestFinished(QNetworkReply *reply)
 	if (reply)
 	{
 		disconnect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(downloadProgress(qint64,qint64)));
+		disconnect(reply, SIGNAL(metaDataChanged()), this, SLOT(requestMetaDataChanged()));
+	}
+
+	if (reply && m_pendingRequests.contains(reply))
+	{
+		RequestInformation information = m_pendingRequests.take(reply);
+		information.finishTime = QDateTime::currentDateTimeUtc();
+		information.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		information.isFromCache = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+		information.isMultiplexed = reply->attribute(QNetworkRequest::HttpPipeliningWasUsedAttribute).toBool();
+#if QT_VERSION >= 0x050300
+		information.isMultiplexed = (information.isMultiplexed || reply->attribute(QNetworkRequest::SpdyWasUsedAttribute).toBool());
+#endif
+
+		if (information.isMultiplexed)
+		{
+			++m_multiplexedRequests;
+		}
+
+		if (information.responseHeaders.isEmpty())
+		{
+			information.responseHeaders = reply->rawHeaderPairs();
+		}
+
+		if (!information.headersTime.isValid())
+		{
+			information.headersTime = information.finishTime;
+		}
+
+		logRequest(information);
+	}
+
+	if (reply && !m_isPrivate && m_snapshot.resources.isEmpty() && reply->operation() == GetOperation && reply->error() == QNetworkReply::NoError && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 200)
+	{
+		m_snapshotResources.append(reply->url());
+	}
+}
+
+void QtWebKitNetworkManager::requestMetaDataChanged()
+{
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (!reply || !m_pendingRequests.contains(reply))
+	{
+		return;
+	}
+
+	RequestInformation &information = m_pendingRequests[reply];
+
+	if (!information.headersTime.isValid())
+	{
+		information.headersTime = QDateTime::currentDateTimeUtc();
+	}
+
+	information.responseHeaders = reply->rawHeaderPairs();
+	information.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+}
+
+void QtWebKitNetworkManager::updateCookies()
+{
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (!reply || !cookieJar())
+	{
+		return;
+	}
+
+	const QList<QNetworkCookie> cookies = reply->header(QNetworkRequest::SetCookieHeader).value<QList<QNetworkCookie> >();
+	const QUrl firstPartyUrl = ((m_widget && m_pendingRequests.value(reply).type != MainDocumentResource) ? m_widget->getUrl() : reply->url());
+
+	if (!cookies.isEmpty() && (!getCookieJar() || getCookieJar()->canAcceptCookies(reply->url(), firstPartyUrl)))
+	{
+		cookieJar()->setCookiesFromUrl(cookies, reply->url());
 	}
 }
 
@@ -283,6 +388,16 @@ void QtWebKitNetworkManager::updateStatus()
 	emit statusChanged(m_finishedRequests, m_startedRequests, m_bytesReceived, m_bytesTotal, m_speed);
 }
 
+void QtWebKitNetworkManager::logRequest(const RequestInformation &information)
+{
+	m_requests.append(information);
+
+	while (m_requests.count() > 500)
+	{
+		m_requests.removeFirst();
+	}
+}
+
 void QtWebKitNetworkManager::updateOptions(const QUrl &url)
 {
 	QString acceptLanguage = SettingsManager::getValue(QLatin1String("Network/AcceptLanguage"), url).toString();
@@ -308,11 +423,28 @@ void QtWebKitNetworkManager::updateOptions(const QUrl &url)
 	m_canSendReferrer = SettingsManager::getValue(QLatin1String("Network/EnableReferrer"), url).toBool();
 }
 
+void QtWebKitNetworkManager::storeSnapshot()
+{
+	if (m_isPrivate || !m_widget || !m_snapshot.resources.isEmpty() || m_snapshotResources.isEmpty())
+	{
+		return;
+	}
+
+	PageSnapshotsManager::storeSnapshot(m_widget->getUrl(), m_snapshotResources);
+
+	m_snapshotResources.clear();
+}
+
 void QtWebKitNetworkManager::setFormRequest(const QUrl &url)
 {
 	m_formRequestUrl = url;
 }
 
+void QtWebKitNetworkManager::setMainRequest(const QUrl &url)
+{
+	m_mainRequestUrl = url.adjusted(QUrl::RemoveFragment);
+}
+
 void QtWebKitNetworkManager::setWidget(QtWebKitWebWidget *widget)
 {
 	m_widget = widget;
@@ -320,7 +452,7 @@ void QtWebKitNetworkManager::setWidget(QtWebKitWebWidget *widget)
 
 QtWebKitNetworkManager* QtWebKitNetworkManager::clone()
 {
-	QtWebKitNetworkManager *manager = new QtWebKitNetworkManager((cache() == NULL), NULL);
+	QtWebKitNetworkManager *manager = new QtWebKitNetworkManager(m_isPrivate, NULL);
 	manager->setCookieJar(getCookieJar()->clone(manager));
 
 	return manager;
@@ -339,10 +471,21 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(QNetworkAccessManager::Oper
 
 	++m_startedRequests;
 
+	const ResourceType type = getResourceType(request);
+
 	if (ContentBlockingManager::isContentBlockingEnabled() && ContentBlockingManager::isUrlBlocked(request, m_widget->getUrl()))
 	{
 		Console::addMessage(QCoreApplication::translate("main", "Blocked content: %0").arg(request.url().url()), Otter::NetworkMessageCategory, LogMessageLevel);
 
+		RequestInformation information = createRequestInformation(operation, request);
+		information.type = type;
+		information.finishTime = information.startTime;
+		information.isBlocked = true;
+
+		logRequest(information);
+
+		++m_blockedRequests;
+
 		QUrl url = QUrl();
 		url.setScheme(QLatin1String("http"));
 
@@ -354,6 +497,41 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(QNetworkAccessManager::Oper
 		return new LocalListingNetworkReply(this, request);
 	}
 
+	if (operation == GetOperation && !m_isPrivate)
+	{
+		if (type == MainDocumentResource)
+		{
+			const QNetworkRequest::CacheLoadControl cacheLoadControl = static_cast<QNetworkRequest::CacheLoadControl>(request.attribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork).toInt());
+			const QDateTime snapshotTime = PageSnapshotsManager::getSnapshotTime(request.url());
+			bool useSnapshot = (snapshotTime.isValid() && NetworkManagerFactory::isWorkingOffline());
+
+			if (!useSnapshot && snapshotTime.isValid() && cacheLoadControl == QNetworkRequest::PreferCache)
+			{
+				const int maximumAge = SettingsManager::getValue(QLatin1String("Cache/PageSnapshotsMaximumAge"), request.url()).toInt();
+
+				useSnapshot = (maximumAge > 0 && snapshotTime.secsTo(QDateTime::currentDateTime()) < maximumAge);
+			}
+
+			m_snapshot = (useSnapshot ? PageSnapshotsManager::getSnapshot(request.url()) : PageSnapshot());
+			m_snapshotResources.clear();
+			m_mainRequestUrl = QUrl();
+		}
+
+		const QString key = request.url().adjusted(QUrl::RemoveFragment).toString();
+
+		if (m_snapshot.resources.contains(key))
+		{
+			QNetworkReply *reply = new SnapshotNetworkReply(this, request, m_snapshot.resources[key]);
+
+			m_pendingRequests[reply] = createRequestInformation(operation, request);
+			m_pendingRequests[reply].type = type;
+
+			m_replies[reply] = qMakePair(0, false);
+
+			return reply;
+		}
+	}
+
 	QNetworkRequest mutableRequest(request);
 
 	if (!m_canSendReferrer)
@@ -377,7 +555,68 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(QNetworkAccessManager::Oper
 
 	mutableRequest.setRawHeader(QStringLiteral("Accept-Language").toLatin1(), (m_acceptLanguage.isEmpty() ? NetworkManagerFactory::getAcceptLanguage().toLatin1() : m_acceptLanguage.toLatin1()));
 
-	QNetworkReply *reply = QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
+	if (static_cast<QNetworkRequest::LoadControl>(request.attribute(QNetworkRequest::CookieLoadControlAttribute).toInt()) == QNetworkRequest::Automatic && cookieJar())
+	{
+		const QList<QNetworkCookie> cookies = cookieJar()->cookiesForUrl(request.url());
+
+		if (!cookies.isEmpty())
+		{
+			mutableRequest.setHeader(QNetworkRequest::CookieHeader, QVariant::fromValue(cookies));
+		}
+	}
+
+	const bool saveCookies = (static_cast<QNetworkRequest::LoadControl>(request.attribute(QNetworkRequest::CookieSaveControlAttribute).toInt()) == QNetworkRequest::Automatic);
+
+	if (type == MainDocumentResource)
+	{
+		mutableRequest.setPriority(QNetworkRequest::HighPriority);
+	}
+
+	NetworkManagerFactory::setupMultiplexing(mutableRequest);
+
+	mutableRequest.setAttribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Manual);
+	mutableRequest.setAttribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Manual);
+
+	QNetworkReply *reply = NULL;
+
+	switch (operation)
+	{
+		case HeadOperation:
+		case GetOperation:
+			reply = NetworkScheduler::createRequest(m_transportManager, operation, mutableRequest, getPriority(request, type), m_widget, this);
+
+			break;
+		case PutOperation:
+			reply = m_transportManager->put(mutableRequest, outgoingData);
+
+			break;
+		case PostOperation:
+			reply = m_transportManager->post(mutableRequest, outgoingData);
+
+			break;
+		case DeleteOperation:
+			reply = m_transportManager->deleteResource(mutableRequest);
+
+			break;
+		case CustomOperation:
+			reply = m_transportManager->sendCustomRequest(mutableRequest, mutableRequest.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray(), outgoingData);
+
+			break;
+		default:
+			reply = QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
+
+			break;
+	}
+
+	if (saveCookies)
+	{
+		connect(reply, SIGNAL(metaDataChanged()), this, SLOT(updateCookies()));
+	}
+
+	m_pendingRequests[reply] = createRequestInformation(operation, mutableRequest);
+	m_pendingRequests[reply].type = type;
+
+	connect(reply, SIGNAL(metaDataChanged()), this, SLOT(requestMetaDataChanged()));
 
 	if (!m_baseReply)
 	{
@@ -388,12 +627,117 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(QNetworkAccessManager::Oper
 
 	connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(downloadProgress(qint64,qint64)));
 
-	if (m_updateTimer == 0)
+	TimersManager::addTask(this, "updateStatus", 500);
+
+	return reply;
+}
+
+QtWebKitNetworkManager::RequestInformation QtWebKitNetworkManager::createRequestInformation(QNetworkAccessManager::Operation operation, const QNetworkRequest &request) const
+{
+	RequestInformation information;
+	information.url = request.url();
+	information.startTime = QDateTime::currentDateTimeUtc();
+
+	switch (operation)
+	{
+		case HeadOperation:
+			information.method = QByteArray("HEAD");
+
+			break;
+		case PutOperation:
+			information.method = QByteArray("PUT");
+
+			break;
+		case PostOperation:
+			information.method = QByteArray("POST");
+
+			break;
+		case DeleteOperation:
+			information.method = QByteArray("DELETE");
+
+			break;
+		case CustomOperation:
+			information.method = request.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+
+			break;
+		default:
+			information.method = QByteArray("GET");
+
+			break;
+	}
+
+	const QList<QByteArray> headers = request.rawHeaderList();
+
+	for (int i = 0; i < headers.count(); ++i)
 	{
-		m_updateTimer = startTimer(500);
+		information.requestHeaders.append(qMakePair(headers.at(i), request.rawHeader(headers.at(i))));
 	}
 
-	return reply;
+	return information;
+}
+
+QtWebKitNetworkManager::ResourceType QtWebKitNetworkManager::getResourceType(const QNetworkRequest &request) const
+{
+	const QByteArray accept = request.rawHeader(QByteArray("Accept"));
+
+	if (accept.contains("text/html") || accept.contains("application/xhtml+xml"))
+	{
+		QWebFrame *frame = qobject_cast<QWebFrame*>(request.originatingObject());
+
+		if (frame && frame != frame->page()->mainFrame())
+		{
+			return SubDocumentResource;
+		}
+
+		if (request.url().adjusted(QUrl::RemoveFragment) == m_mainRequestUrl)
+		{
+			return MainDocumentResource;
+		}
+	}
+
+	const QString path = request.url().path().toLower();
+
+	if (accept.startsWith("text/css") || path.endsWith(QLatin1String(".css")))
+	{
+		return StyleSheetResource;
+	}
+
+	if (path.endsWith(QLatin1String(".js")))
+	{
+		return ScriptResource;
+	}
+
+	if (path.endsWith(QLatin1String(".woff")) || path.endsWith(QLatin1String(".ttf")) || path.endsWith(QLatin1String(".otf")) || path.endsWith(QLatin1String(".eot")))
+	{
+		return FontResource;
+	}
+
+	if (accept.startsWith("image/") || path.endsWith(QLatin1String(".png")) || path.endsWith(QLatin1String(".jpg")) || path.endsWith(QLatin1String(".jpeg")) || path.endsWith(QLatin1String(".gif")) || path.endsWith(QLatin1String(".webp")) || path.endsWith(QLatin1String(".svg")) || path.endsWith(QLatin1String(".ico")))
+	{
+		return ImageResource;
+	}
+
+	return OtherResource;
+}
+
+NetworkScheduler::RequestPriority QtWebKitNetworkManager::getPriority(const QNetworkRequest &request, ResourceType type) const
+{
+	if (request.hasRawHeader(QByteArray("Purpose")) || request.hasRawHeader(QByteArray("X-Purpose")) || request.hasRawHeader(QByteArray("X-Moz")))
+	{
+		return NetworkScheduler::PrefetchPriority;
+	}
+
+	switch (type)
+	{
+		case MainDocumentResource:
+			return NetworkScheduler::DocumentPriority;
+		case FontResource:
+			return NetworkScheduler::FontPriority;
+		case ImageResource:
+			return NetworkScheduler::ImagePriority;
+		default:
+			return NetworkScheduler::ScriptPriority;
+	}
 }
 
 QHash<QByteArray, QByteArray> QtWebKitNetworkManager::getHeaders() const
@@ -413,10 +757,186 @@ QHash<QByteArray, QByteArray> QtWebKitNetworkManager::getHeaders() const
 	return headers;
 }
 
+QList<QtWebKitNetworkManager::RequestInformation> QtWebKitNetworkManager::getRequests() const
+{
+	QList<RequestInformation> requests = m_requests;
+	requests.append(m_pendingRequests.values());
+
+	return requests;
+}
+
+QJsonObject QtWebKitNetworkManager::getHttpArchive() const
+{
+	const QString dateFormat = QLatin1String("yyyy-MM-ddTHH:mm:ss.zzzZ");
+	const QList<RequestInformation> requests = getRequests();
+	QHash<QString, QString> proxies;
+	QJsonArray entries;
+
+	for (int i = 0; i < requests.count(); ++i)
+	{
+		const RequestInformation &information = requests.at(i);
+		const qint64 wait = (information.headersTime.isValid() ? information.startTime.msecsTo(information.headersTime) : 0);
+		const qint64 receive = ((information.headersTime.isValid() && information.finishTime.isValid()) ? information.headersTime.msecsTo(information.finishTime) : 0);
+		QJsonArray requestHeaders;
+
+		for (int j = 0; j < information.requestHeaders.count(); ++j)
+		{
+			QJsonObject header;
+			header[QLatin1String("name")] = QString(information.requestHeaders.at(j).first);
+			header[QLatin1String("value")] = QString(information.requestHeaders.at(j).second);
+
+			requestHeaders.append(header);
+		}
+
+		QJsonArray responseHeaders;
+		QString mimeType;
+		QString redirectUrl;
+
+		for (int j = 0; j < information.responseHeaders.count(); ++j)
+		{
+			const QString name(information.responseHeaders.at(j).first);
+			const QString value(information.responseHeaders.at(j).second);
+
+			if (name.compare(QLatin1String("Content-Type"), Qt::CaseInsensitive) == 0)
+			{
+				mimeType = value;
+			}
+			else if (name.compare(QLatin1String("Location"), Qt::CaseInsensitive) == 0)
+			{
+				redirectUrl = value;
+			}
+
+			QJsonObject header;
+			header[QLatin1String("name")] = name;
+			header[QLatin1String("value")] = value;
+
+			responseHeaders.append(header);
+		}
+
+		QJsonArray queryString;
+		const QList<QPair<QString, QString> > queryItems = QUrlQuery(information.url).queryItems(QUrl::FullyDecoded);
+
+		for (int j = 0; j < queryItems.count(); ++j)
+		{
+			QJsonObject item;
+			item[QLatin1String("name")] = queryItems.at(j).first;
+			item[QLatin1String("value")] = queryItems.at(j).second;
+
+			queryString.append(item);
+		}
+
+		QJsonObject request;
+		request[QLatin1String("method")] = QString(information.method);
+		request[QLatin1String("url")] = information.url.toString();
+		request[QLatin1String("httpVersion")] = QLatin1String("HTTP/1.1");
+		request[QLatin1String("cookies")] = QJsonArray();
+		request[QLatin1String("headers")] = requestHeaders;
+		request[QLatin1String("queryString")] = queryString;
+		request[QLatin1String("headersSize")] = -1;
+		request[QLatin1String("bodySize")] = -1;
+
+		QJsonObject content;
+		content[QLatin1String("size")] = information.bytesReceived;
+		content[QLatin1String("mimeType")] = mimeType;
+
+		QJsonObject response;
+		response[QLatin1String("status")] = information.statusCode;
+		response[QLatin1String("statusText")] = QString();
+		response[QLatin1String("httpVersion")] = (information.headersTime.isValid() ? QLatin1String("HTTP/1.1") : QString());
+		response[QLatin1String("cookies")] = QJsonArray();
+		response[QLatin1String("headers")] = responseHeaders;
+		response[QLatin1String("content")] = content;
+		response[QLatin1String("redirectURL")] = redirectUrl;
+		response[QLatin1String("headersSize")] = -1;
+		response[QLatin1String("bodySize")] = information.bytesReceived;
+
+		QJsonObject timings;
+		timings[QLatin1String("send")] = 0;
+		timings[QLatin1String("wait")] = wait;
+		timings[QLatin1String("receive")] = receive;
+
+		QString type;
+
+		switch (information.type)
+		{
+			case MainDocumentResource:
+				type = QLatin1String("document");
+
+				break;
+			case SubDocumentResource:
+				type = QLatin1String("subdocument");
+
+				break;
+			case StyleSheetResource:
+				type = QLatin1String("stylesheet");
+
+				break;
+			case ScriptResource:
+				type = QLatin1String("script");
+
+				break;
+			case FontResource:
+				type = QLatin1String("font");
+
+				break;
+			case ImageResource:
+				type = QLatin1String("image");
+
+				break;
+			default:
+				type = QLatin1String("other");
+
+				break;
+		}
+
+		// Resolved only on export, automatic proxy scripts would block the GUI thread for every request otherwise
+		const QString origin = information.url.adjusted(QUrl::RemovePath | QUrl::RemoveQuery | QUrl::RemoveFragment | QUrl::RemoveUserInfo).toString();
+
+		if (!information.url.isLocalFile() && !proxies.contains(origin))
+		{
+			const QList<QNetworkProxy> proxyList = QNetworkProxyFactory::proxyForQuery(QNetworkProxyQuery(information.url));
+
+			proxies[origin] = ((!proxyList.isEmpty() && proxyList.first().type() != QNetworkProxy::NoProxy) ? QStringLiteral("%1:%2").arg(proxyList.first().hostName()).arg(proxyList.first().port()) : QString());
+		}
+
+		const QString proxy = proxies.value(origin);
+		QJsonObject entry;
+		entry[QLatin1String("startedDateTime")] = information.startTime.toString(dateFormat);
+		entry[QLatin1String("time")] = (wait + receive);
+		entry[QLatin1String("request")] = request;
+		entry[QLatin1String("response")] = response;
+		entry[QLatin1String("cache")] = QJsonObject();
+		entry[QLatin1String("timings")] = timings;
+		entry[QLatin1String("_resourceType")] = type;
+		entry[QLatin1String("_fromCache")] = information.isFromCache;
+		entry[QLatin1String("_multiplexed")] = information.isMultiplexed;
+		entry[QLatin1String("_blocked")] = information.isBlocked;
+		entry[QLatin1String("_proxy")] = proxy;
+
+		entries.append(entry);
+	}
+
+	QJsonObject creator;
+	creator[QLatin1String("name")] = QCoreApplication::applicationName();
+	creator[QLatin1String("version")] = QCoreApplication::applicationVersion();
+
+	QJsonObject log;
+	log[QLatin1String("version")] = QLatin1String("1.2");
+	log[QLatin1String("creator")] = creator;
+	log[QLatin1String("entries")] = entries;
+
+	QJsonObject archive;
+	archive[QLatin1String("log")] = log;
+
+	return archive;
+}
+
 QVariantHash QtWebKitNetworkManager::getStatistics() const
 {
 	QVariantHash statistics;
+	statistics[QLatin1String("blockedRequests")] = m_blockedRequests;
 	statistics[QLatin1String("finishedRequests")] = m_finishedRequests;
+	statistics[QLatin1String("multiplexedRequests")] = m_multiplexedRequests;
 	statistics[QLatin1String("startedRequests")] = m_startedRequests;
 	statistics[QLatin1String("bytesReceived")] = m_bytesReceived;
 	statistics[QLatin1String("bytesTotal")] = m_bytesTotal;
@@ -22,7 +22,12 @@
 
 #include "../../../../core/NetworkManager.h"
 #include "../../../../core/NetworkManagerFactory.h"
+#include "../../../../core/NetworkScheduler.h"
+#include "../../../../core/PageSnapshotsManager.h"
 
+#include <QtCore/QDateTime>
+#include <QtCore/QJsonObject>
+#include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
 
 namespace Otter
@@ -35,43 +40,91 @@ class QtWebKitNetworkManager : public NetworkManager
 	Q_OBJECT
 
 public:
+	enum ResourceType
+	{
+		OtherResource = 0,
+		MainDocumentResource = 1,
+		SubDocumentResource = 2,
+		StyleSheetResource = 3,
+		ScriptResource = 4,
+		FontResource = 5,
+		ImageResource = 6
+	};
+
+	struct RequestInformation
+	{
+		QUrl url;
+		QByteArray method;
+		QList<QNetworkReply::RawHeaderPair> requestHeaders;
+		QList<QNetworkReply::RawHeaderPair> responseHeaders;
+		QDateTime startTime;
+		QDateTime headersTime;
+		QDateTime finishTime;
+		ResourceType type;
+		qint64 bytesReceived;
+		int statusCode;
+		bool isFromCache;
+		bool isMultiplexed;
+		bool isBlocked;
+
+		RequestInformation() : type(OtherResource), bytesReceived(0), statusCode(0), isFromCache(false), isMultiplexed(false), isBlocked(false) {}
+	};
+
 	explicit QtWebKitNetworkManager(bool isPrivate, QtWebKitWebWidget *widget);
 
 	QHash<QByteArray, QByteArray> getHeaders() const;
+	QList<RequestInformation> getRequests() const;
+	QJsonObject getHttpArchive() const;
 	QVariantHash getStatistics() const;
 
 protected:
-	void timerEvent(QTimerEvent *event);
 	void resetStatistics();
-	void updateStatus();
 	void updateOptions(const QUrl &url);
+	void logRequest(const RequestInformation &information);
+	void storeSnapshot();
 	void setFormRequest(const QUrl &url);
+	void setMainRequest(const QUrl &url);
 	void setWidget(QtWebKitWebWidget *widget);
 	QtWebKitNetworkManager *clone();
 	QNetworkReply* createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData);
+	RequestInformation createRequestInformation(Operation operation, const QNetworkRequest &request) const;
+	ResourceType getResourceType(const QNetworkRequest &request) const;
+	NetworkScheduler::RequestPriority getPriority(const QNetworkRequest &request, ResourceType type) const;
 
 protected slots:
 	void handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator);
+	void handleTransportAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator);
 	void handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
 	void handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
 	void downloadProgress(qint64 bytesReceived, qint64 bytesTotal);
 	void requestFinished(QNetworkReply *reply);
+	void requestMetaDataChanged();
+	void updateCookies();
+	void updateStatus();
 
 private:
 	QtWebKitWebWidget *m_widget;
+	QNetworkAccessManager *m_transportManager;
 	QNetworkReply *m_baseReply;
 	QString m_acceptLanguage;
 	QUrl m_formRequestUrl;
+	QUrl m_mainRequestUrl;
 	QHash<QNetworkReply*, QPair<qint64, bool> > m_replies;
+	QHash<QNetworkReply*, RequestInformation> m_pendingRequests;
+	QList<RequestInformation> m_requests;
+	QList<QUrl> m_snapshotResources;
+	PageSnapshot m_snapshot;
 	qint64 m_speed;
 	qint64 m_bytesReceivedDifference;
 	qint64 m_bytesReceived;
 	qint64 m_bytesTotal;
+	int m_blockedRequests;
 	int m_finishedRequests;
+	int m_multiplexedRequests;
 	int m_startedRequests;
-	int m_updateTimer;
 	NetworkManagerFactory::DoNotTrackPolicy m_doNotTrackPolicy;
 	bool m_canSendReferrer;
+	bool m_isPrivate;
 
 signals:
 	void messageChanged(const QString &message = QString());
@@ -103,6 +103,11 @@ void QtWebKitWebBackend::optionChanged(const QString &option)
 	globalSettings->setOfflineWebApplicationCacheQuota(SettingsManager::getValue(QLatin1String("Content/OfflineWebApplicationCacheLimit")).toInt() * 1024);
 }
 
+void QtWebKitWebBackend::clearCaches()
+{
+	QWebSettings::clearMemoryCaches();
+}
+
 WebWidget* QtWebKitWebBackend::createWidget(bool isPrivate, ContentsWidget *parent)
 {
 	if (!m_isInitialized)
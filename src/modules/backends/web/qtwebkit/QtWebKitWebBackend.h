@@ -32,6 +32,7 @@ class QtWebKitWebBackend : public WebBackend
 public:
 	explicit QtWebKitWebBackend(QObject *parent = NULL);
 
+	void clearCaches();
 	WebWidget* createWidget(bool isPrivate = false, ContentsWidget *parent = NULL);
 	QString getTitle() const;
 	QString getDescription() const;
@@ -302,7 +302,17 @@ bool QtWebKitWebPage::acceptNavigationRequest(QWebFrame *frame, const QNetworkRe
 		m_widget->markPageRealoded();
 	}
 
-	return QWebPage::acceptNavigationRequest(frame, request, type);
+	if (!QWebPage::acceptNavigationRequest(frame, request, type))
+	{
+		return false;
+	}
+
+	if (frame && frame == mainFrame())
+	{
+		m_networkManager->setMainRequest(request.url());
+	}
+
+	return true;
 }
 
 bool QtWebKitWebPage::javaScriptConfirm(QWebFrame *frame, const QString &message)
@@ -27,11 +27,13 @@
 #include "../../../../core/BookmarksManager.h"
 #include "../../../../core/Console.h"
 #include "../../../../core/CookieJar.h"
+#include "../../../../core/FaviconsManager.h"
 #include "../../../../core/GesturesManager.h"
 #include "../../../../core/HistoryManager.h"
 #include "../../../../core/NetworkCache.h"
 #include "../../../../core/NetworkManager.h"
 #include "../../../../core/NetworkManagerFactory.h"
+#include "../../../../core/NetworkPredictor.h"
 #include "../../../../core/SearchesManager.h"
 #include "../../../../core/SessionsManager.h"
 #include "../../../../core/SettingsManager.h"
@@ -44,7 +46,9 @@
 #include "../../../../ui/WebsitePreferencesDialog.h"
 
 #include <QtCore/QEventLoop>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QTimer>
 #include <QtCore/QUuid>
@@ -314,6 +318,8 @@ void QtWebKitWebWidget::pageLoadFinished(bool ok)
 		{
 			SessionsManager::markSessionModified();
 
+			m_networkManager->storeSnapshot();
+
 			if (m_historyEntry >= 0)
 			{
 				HistoryManager::updateEntry(m_historyEntry, getUrl(), m_webView->title(), m_webView->icon());
@@ -443,6 +449,11 @@ void QtWebKitWebWidget::hideInspector()
 void QtWebKitWebWidget::linkHovered(const QString &link)
 {
 	setStatusMessage(link, true);
+
+	if (!link.isEmpty())
+	{
+		NetworkPredictor::predictUrl(QUrl(link), isPrivate());
+	}
 }
 
 void QtWebKitWebWidget::markPageRealoded()
@@ -522,6 +533,11 @@ void QtWebKitWebWidget::notifyUrlChanged(const QUrl &url)
 
 void QtWebKitWebWidget::notifyIconChanged()
 {
+	if (!isPrivate())
+	{
+		FaviconsManager::setIcon(getUrl(), m_webView->icon());
+	}
+
 	emit iconChanged(getIcon());
 }
 
@@ -1096,6 +1112,29 @@ void QtWebKitWebWidget::triggerAction(ActionIdentifier action, bool checked)
 				}
 			}
 
+			break;
+		case ExportNetworkLogAction:
+			{
+				const QString path = TransfersManager::getSavePath((getUrl().host().isEmpty() ? tr("page") : getUrl().host()) + QLatin1String(".har"));
+
+				if (path.isEmpty())
+				{
+					break;
+				}
+
+				QFile file(path);
+
+				if (!file.open(QIODevice::WriteOnly))
+				{
+					Console::addMessage(tr("Failed to save network log %0: %1").arg(path).arg(file.errorString()), OtherMessageCategory, ErrorMessageLevel);
+
+					break;
+				}
+
+				file.write(QJsonDocument(m_networkManager->getHttpArchive()).toJson());
+				file.close();
+			}
+
 			break;
 		case LoadPluginsAction:
 			{
@@ -1552,6 +1591,10 @@ QAction* QtWebKitWebWidget::getAction(ActionIdentifier action)
 		case WebsitePreferencesAction:
 			ActionsManager::setupLocalAction(ActionsManager::getAction(QLatin1String("WebsitePreferences"), this), actionObject, false);
 
+			break;
+		case ExportNetworkLogAction:
+			ActionsManager::setupLocalAction(ActionsManager::getAction(QLatin1String("ExportNetworkLog"), this), actionObject, false);
+
 			break;
 		case ZoomInAction:
 			ActionsManager::setupLocalAction(ActionsManager::getAction(QLatin1String("ZoomIn"), this), actionObject, true);
@@ -132,6 +132,8 @@ void CacheContentsWidget::populateCache()
 	connect(cache, SIGNAL(entryRemoved(QUrl)), this, SLOT(removeEntry(QUrl)));
 	connect(m_model, SIGNAL(modelReset()), this, SLOT(updateActions()));
 	connect(m_ui->cacheView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)), this, SLOT(updateActions()));
+
+	updateActions();
 }
 
 void CacheContentsWidget::filterCache(const QString &filter)
@@ -210,44 +212,42 @@ void CacheContentsWidget::addEntry(const QUrl &entry)
 	}
 
 	NetworkCache *cache = NetworkManagerFactory::getCache();
-	QIODevice *device = cache->data(entry);
-	const QNetworkCacheMetaData metaData = cache->metaData(entry);
-	const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
-	QString type;
+	const NetworkCacheEntry information = cache->getEntry(entry);
+	QMimeType mimeType;
 
-	for (int i = 0; i < headers.count(); ++i)
+	if (information.contentType.isEmpty())
 	{
-		if (headers.at(i).first == QStringLiteral("Content-Type").toLatin1())
+		QIODevice *device = cache->data(entry);
+
+		if (device)
 		{
-			type = QString(headers.at(i).second);
+			mimeType = QMimeDatabase().mimeTypeForData(device);
 
-			break;
+			device->deleteLater();
 		}
 	}
+	else
+	{
+		mimeType = QMimeDatabase().mimeTypeForName(information.contentType.section(QLatin1Char(';'), 0, 0).trimmed());
+	}
 
-	const QMimeType mimeType = ((type.isEmpty() && device) ? QMimeDatabase().mimeTypeForData(device) : QMimeDatabase().mimeTypeForName(type));
 	QList<QStandardItem*> entryItems;
 	entryItems.append(new QStandardItem(entry.path()));
 	entryItems.append(new QStandardItem(mimeType.name()));
-	entryItems.append(new QStandardItem(device ? Utils::formatUnit(device->size()) : QString()));
-	entryItems.append(new QStandardItem(metaData.lastModified().toString()));
-	entryItems.append(new QStandardItem(metaData.expirationDate().toString()));
+	entryItems.append(new QStandardItem(Utils::formatUnit(information.size)));
+	entryItems.append(new QStandardItem(information.lastModified.toString()));
+	entryItems.append(new QStandardItem(information.expirationDate.toString()));
 	entryItems[0]->setData(entry, Qt::UserRole);
-	entryItems[2]->setData((device ? device->size() : 0), Qt::UserRole);
+	entryItems[2]->setData(information.size, Qt::UserRole);
 
 	QStandardItem *sizeItem = m_model->item(domainItem->row(), 2);
 
-	if (sizeItem && device)
+	if (sizeItem)
 	{
-		sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + device->size()), Qt::UserRole);
+		sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + information.size), Qt::UserRole);
 		sizeItem->setText(Utils::formatUnit(sizeItem->data(Qt::UserRole).toLongLong()));
 	}
 
-	if (device)
-	{
-		device->deleteLater();
-	}
-
 	domainItem->appendRow(entryItems);
 	domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
 
@@ -403,18 +403,20 @@ void CacheContentsWidget::showContextMenu(const QPoint &point)
 
 void CacheContentsWidget::updateActions()
 {
+	NetworkCache *cache = NetworkManagerFactory::getCache();
 	const QModelIndex index = (m_ui->cacheView->selectionModel()->hasSelection() ? m_ui->cacheView->selectionModel()->currentIndex() : QModelIndex());
 	const QUrl entry = getEntry(index);
 	const QString domain = ((index.isValid() && index.parent() == m_model->invisibleRootItem()->index()) ? index.sibling(index.row(), 0).data(Qt::ToolTipRole).toString() : entry.host());
+	const qint64 lookups = (cache->getMemoryHits() + cache->getMemoryMisses());
 
 	m_ui->locationLabelWidget->setText(QString());
+	m_ui->memoryHitsLabelWidget->setText((lookups > 0) ? tr("%1% (%2 of %3 lookups)").arg(QString::number(((cache->getMemoryHits() * 100.0) / lookups), 'f', 1)).arg(cache->getMemoryHits()).arg(lookups) : tr("No lookups"));
 	m_ui->previewLabel->hide();
 	m_ui->previewLabel->setPixmap(QPixmap());
 	m_ui->deleteButton->setEnabled(!domain.isEmpty());
 
 	if (entry.isValid())
 	{
-		NetworkCache *cache = NetworkManagerFactory::getCache();
 		QIODevice *device = cache->data(entry);
 		const QNetworkCacheMetaData metaData = cache->metaData(entry);
 		const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
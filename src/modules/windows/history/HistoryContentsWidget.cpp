@@ -26,6 +26,7 @@
 #include "ui_HistoryContentsWidget.h"
 
 #include <QtCore/QTimer>
+#include <QtCore/QTimerEvent>
 #include <QtGui/QClipboard>
 #include <QtGui/QMouseEvent>
 #include <QtWidgets/QMenu>
@@ -35,6 +36,8 @@ namespace Otter
 
 HistoryContentsWidget::HistoryContentsWidget(Window *window) : ContentsWidget(window),
 	m_model(new QStandardItemModel(this)),
+	m_filterModel(NULL),
+	m_filterTimer(0),
 	m_isLoading(true),
 	m_ui(new Ui::HistoryContentsWidget)
 {
@@ -78,7 +81,7 @@ HistoryContentsWidget::HistoryContentsWidget(Window *window) : ContentsWidget(wi
 	connect(HistoryManager::getInstance(), SIGNAL(entryUpdated(qint64)), this, SLOT(updateEntry(qint64)));
 	connect(HistoryManager::getInstance(), SIGNAL(entryRemoved(qint64)), this, SLOT(removeEntry(qint64)));
 	connect(HistoryManager::getInstance(), SIGNAL(dayChanged()), this, SLOT(populateEntries()));
-	connect(m_ui->filterLineEdit, SIGNAL(textChanged(QString)), this, SLOT(filterHistory(QString)));
+	connect(m_ui->filterLineEdit, SIGNAL(textChanged(QString)), this, SLOT(scheduleFilter(QString)));
 	connect(m_ui->historyView, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(openEntry(QModelIndex)));
 	connect(m_ui->historyView, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showContextMenu(QPoint)));
 }
@@ -88,6 +91,18 @@ HistoryContentsWidget::~HistoryContentsWidget()
 	delete m_ui;
 }
 
+void HistoryContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_filterTimer)
+	{
+		killTimer(m_filterTimer);
+
+		m_filterTimer = 0;
+
+		filterHistory(m_ui->filterLineEdit->text());
+	}
+}
+
 void HistoryContentsWidget::changeEvent(QEvent *event)
 {
 	QWidget::changeEvent(event);
@@ -108,40 +123,89 @@ void HistoryContentsWidget::print(QPrinter *printer)
 	m_ui->historyView->render(printer);
 }
 
+void HistoryContentsWidget::scheduleFilter(const QString &filter)
+{
+	if (m_filterTimer != 0)
+	{
+		killTimer(m_filterTimer);
+
+		m_filterTimer = 0;
+	}
+
+	if (filter.isEmpty())
+	{
+		filterHistory(filter);
+	}
+	else
+	{
+		m_filterTimer = startTimer(250);
+	}
+}
+
 void HistoryContentsWidget::filterHistory(const QString &filter)
 {
-	for (int i = 0; i < m_model->rowCount(); ++i)
+	if (filter.isEmpty() && !m_filterModel)
 	{
-		QStandardItem *groupItem = m_model->item(i, 0);
+		return;
+	}
 
-		if (!groupItem)
+	QStandardItemModel *model = NULL;
+
+	if (!filter.isEmpty())
+	{
+		model = new QStandardItemModel(this);
+		model->setHorizontalHeaderLabels(QStringList() << tr("Address") << tr("Title") << tr("Date"));
+
+		for (int i = 0; i < m_model->rowCount(); ++i)
 		{
-			continue;
+			QStandardItem *groupItem = new QStandardItem(m_model->item(i, 0)->icon(), m_model->item(i, 0)->text());
+			groupItem->setData(m_model->item(i, 0)->data(Qt::UserRole), Qt::UserRole);
+
+			model->appendRow(groupItem);
 		}
 
-		bool found = (filter.isEmpty() && groupItem->rowCount() > 0);
+		const QList<HistoryEntry> entries = HistoryManager::findEntries(filter, -1);
 
-		for (int j = 0; j < groupItem->rowCount(); ++j)
+		for (int i = 0; i < entries.count(); ++i)
 		{
-			QStandardItem *entryItem = groupItem->child(j, 0);
-
-			if (!entryItem)
+			for (int j = 0; j < model->rowCount(); ++j)
 			{
-				continue;
-			}
+				QStandardItem *groupItem = model->item(j, 0);
 
-			const bool match = (filter.isEmpty() || entryItem->text().contains(filter, Qt::CaseInsensitive) || groupItem->child(j, 1)->text().contains(filter, Qt::CaseInsensitive));
+				if (entries.at(i).time.date() >= groupItem->data(Qt::UserRole).toDate() || !groupItem->data(Qt::UserRole).toDate().isValid())
+				{
+					groupItem->appendRow(createEntryItems(entries.at(i)));
 
-			if (match)
-			{
-				found = true;
+					break;
+				}
 			}
-
-			m_ui->historyView->setRowHidden(j, groupItem->index(), !match);
 		}
+	}
 
-		m_ui->historyView->setRowHidden(i, m_model->invisibleRootItem()->index(), !found);
-		m_ui->historyView->setExpanded(groupItem->index(), !filter.isEmpty());
+	QItemSelectionModel *selectionModel = m_ui->historyView->selectionModel();
+
+	m_ui->historyView->setModel(model ? model : m_model);
+	m_ui->historyView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+	delete selectionModel;
+
+	if (m_filterModel)
+	{
+		m_filterModel->deleteLater();
+	}
+
+	m_filterModel = model;
+
+	QStandardItemModel *viewModel = (model ? model : m_model);
+
+	for (int i = 0; i < viewModel->rowCount(); ++i)
+	{
+		m_ui->historyView->setRowHidden(i, viewModel->invisibleRootItem()->index(), (viewModel->item(i, 0)->rowCount() == 0));
+	}
+
+	if (model)
+	{
+		m_ui->historyView->expandAll();
 	}
 }
 
@@ -184,6 +248,11 @@ void HistoryContentsWidget::populateEntries()
 	m_isLoading = false;
 
 	emit loadingChanged(false);
+
+	if (m_filterModel)
+	{
+		filterHistory(m_ui->filterLineEdit->text());
+	}
 }
 
 void HistoryContentsWidget::addEntry(qint64 entry)
@@ -217,13 +286,7 @@ void HistoryContentsWidget::addEntry(const HistoryEntry &entry)
 		return;
 	}
 
-	QList<QStandardItem*> entryItems;
-	entryItems.append(new QStandardItem((entry.icon.isNull() ? Utils::getIcon(QLatin1String("text-html")) : entry.icon), entry.url.toString().replace(QLatin1String("%23"), QString(QLatin1Char('#')))));
-	entryItems.append(new QStandardItem(entry.title.isEmpty() ? tr("(Untitled)") : entry.title));
-	entryItems.append(new QStandardItem(entry.time.toString()));
-	entryItems[0]->setData(entry.identifier, Qt::UserRole);
-
-	groupItem->appendRow(entryItems);
+	groupItem->appendRow(createEntryItems(entry));
 
 	m_ui->historyView->setRowHidden(groupItem->row(), groupItem->index().parent(), false);
 
@@ -280,6 +343,11 @@ void HistoryContentsWidget::removeEntry(qint64 entry)
 			}
 		}
 	}
+
+	if (m_filterModel)
+	{
+		filterHistory(m_ui->filterLineEdit->text());
+	}
 }
 
 void HistoryContentsWidget::removeEntry()
@@ -392,6 +460,17 @@ void HistoryContentsWidget::showContextMenu(const QPoint &point)
 	menu.exec(m_ui->historyView->mapToGlobal(point));
 }
 
+QList<QStandardItem*> HistoryContentsWidget::createEntryItems(const HistoryEntry &entry) const
+{
+	QList<QStandardItem*> entryItems;
+	entryItems.append(new QStandardItem((entry.icon.isNull() ? Utils::getIcon(QLatin1String("text-html")) : entry.icon), entry.url.toString().replace(QLatin1String("%23"), QString(QLatin1Char('#')))));
+	entryItems.append(new QStandardItem(entry.title.isEmpty() ? tr("(Untitled)") : entry.title));
+	entryItems.append(new QStandardItem(entry.time.toString()));
+	entryItems[0]->setData(entry.identifier, Qt::UserRole);
+
+	return entryItems;
+}
+
 QStandardItem* HistoryContentsWidget::findEntry(qint64 entry)
 {
 	for (int i = 0; i < m_model->rowCount(); ++i)
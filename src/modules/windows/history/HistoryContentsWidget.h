@@ -53,11 +53,14 @@ public:
 	bool eventFilter(QObject *object, QEvent *event);
 
 protected:
+	void timerEvent(QTimerEvent *event);
 	void changeEvent(QEvent *event);
 	QStandardItem* findEntry(qint64 entry);
+	QList<QStandardItem*> createEntryItems(const HistoryEntry &entry) const;
 	qint64 getEntry(const QModelIndex &index) const;
 
 protected slots:
+	void scheduleFilter(const QString &filter);
 	void filterHistory(const QString &filter);
 	void populateEntries();
 	void addEntry(qint64 entry);
@@ -73,7 +76,9 @@ protected slots:
 
 private:
 	QStandardItemModel *m_model;
+	QStandardItemModel *m_filterModel;
 	QHash<ActionIdentifier, QAction*> m_actions;
+	int m_filterTimer;
 	bool m_isLoading;
 	Ui::HistoryContentsWidget *m_ui;
 };
@@ -26,6 +26,7 @@
 #include "../core/AddressCompletionModel.h"
 #include "../core/BookmarksManager.h"
 #include "../core/BookmarksModel.h"
+#include "../core/NetworkPredictor.h"
 #include "../core/SearchesManager.h"
 #include "../core/SettingsManager.h"
 #include "../core/Utils.h"
@@ -516,7 +517,14 @@ void AddressWidget::updateIcons()
 
 void AddressWidget::setCompletion(const QString &text)
 {
+	AddressCompletionModel::getInstance()->setFilter(text);
+
 	m_completer->setCompletionPrefix(text);
+
+	if (m_window && hasFocus() && !m_window->isPrivate() && !m_completer->currentCompletion().isEmpty())
+	{
+		NetworkPredictor::predictUrl(QUrl::fromUserInput(m_completer->currentCompletion()), false);
+	}
 }
 
 void AddressWidget::setIcon(const QIcon &icon)
@@ -18,23 +18,24 @@
 **************************************************************************/
 
 #include "ClearHistoryDialog.h"
-#include "../core/HistoryManager.h"
-#include "../core/NetworkManagerFactory.h"
+#include "../core/ClearHistoryJob.h"
 #include "../core/SettingsManager.h"
-#include "../core/TransfersManager.h"
 
 #include "ui_ClearHistoryDialog.h"
 
+#include <QtWidgets/QCheckBox>
 #include <QtWidgets/QPushButton>
 
 namespace Otter
 {
 
 ClearHistoryDialog::ClearHistoryDialog(const QStringList &clearSettings, bool configureMode, QWidget *parent) : QDialog(parent),
+	m_job(NULL),
 	m_configureMode(configureMode),
 	m_ui(new Ui::ClearHistoryDialog)
 {
 	m_ui->setupUi(this);
+	m_ui->progressBar->hide();
 
 	QStringList settings = clearSettings;
 	settings.removeAll(QString());
@@ -53,7 +54,8 @@ ClearHistoryDialog::ClearHistoryDialog(const QStringList &clearSettings, bool co
 		m_ui->buttonBox->button(QDialogButtonBox::Ok)->setText(tr("Clear Now"));
 		m_ui->periodSpinBox->setValue(SettingsManager::getValue(QLatin1String("History/ManualClearPeriod")).toInt());
 
-		connect(this, SIGNAL(accepted()), this, SLOT(clearHistory()));
+		disconnect(m_ui->buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
+		connect(m_ui->buttonBox, SIGNAL(accepted()), this, SLOT(clearHistory()));
 	}
 
 	m_ui->clearBrowsingHistoryCheckBox->setChecked(settings.contains(QLatin1String("browsing")));
@@ -88,28 +90,45 @@ void ClearHistoryDialog::changeEvent(QEvent *event)
 
 void ClearHistoryDialog::clearHistory()
 {
-	if (m_ui->clearBrowsingHistoryCheckBox->isChecked())
+	if (m_job)
 	{
-		HistoryManager::clearHistory(m_ui->periodSpinBox->value());
+		return;
 	}
 
-	if (m_ui->clearCookiesCheckBox->isChecked())
-	{
-		NetworkManagerFactory::clearCookies(m_ui->periodSpinBox->value());
-	}
+	SettingsManager::setValue(QLatin1String("History/ManualClearOptions"), getClearSettings());
+	SettingsManager::setValue(QLatin1String("History/ManualClearPeriod"), m_ui->periodSpinBox->value());
 
-	if (m_ui->clearDownloadsHistoryCheckBox->isChecked())
+	m_job = new ClearHistoryJob(getClearSettings(), m_ui->periodSpinBox->value(), this);
+
+	const QList<QCheckBox*> checkBoxes = findChildren<QCheckBox*>();
+
+	for (int i = 0; i < checkBoxes.count(); ++i)
 	{
-		TransfersManager::clearTransfers(m_ui->periodSpinBox->value());
+		checkBoxes.at(i)->setEnabled(false);
 	}
 
-	if (m_ui->clearCachesCheckBox->isChecked())
+	m_ui->periodWidget->setEnabled(false);
+	m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+	m_ui->progressBar->setValue(0);
+	m_ui->progressBar->show();
+
+	connect(m_job, SIGNAL(progressChanged(int)), m_ui->progressBar, SLOT(setValue(int)));
+	connect(m_job, SIGNAL(finished()), this, SLOT(accept()));
+	connect(m_job, SIGNAL(cancelled()), this, SLOT(reject()));
+
+	m_job->start();
+}
+
+void ClearHistoryDialog::reject()
+{
+	if (m_job && m_job->isRunning())
 	{
-		NetworkManagerFactory::clearCache(m_ui->periodSpinBox->value());
+		m_job->cancel();
+
+		return;
 	}
 
-	SettingsManager::setValue(QLatin1String("History/ManualClearOptions"), getClearSettings());
-	SettingsManager::setValue(QLatin1String("History/ManualClearPeriod"), m_ui->periodSpinBox->value());
+	QDialog::reject();
 }
 
 QStringList ClearHistoryDialog::getClearSettings() const
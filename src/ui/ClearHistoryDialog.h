@@ -25,6 +25,8 @@
 namespace Otter
 {
 
+class ClearHistoryJob;
+
 namespace Ui
 {
 	class ClearHistoryDialog;
@@ -40,6 +42,9 @@ public:
 
 	QStringList getClearSettings() const;
 
+public slots:
+	void reject();
+
 protected:
 	void changeEvent(QEvent *event);
 
@@ -47,6 +52,7 @@ protected slots:
 	void clearHistory();
 
 private:
+	ClearHistoryJob *m_job;
 	bool m_configureMode;
 	Ui::ClearHistoryDialog *m_ui;
 };
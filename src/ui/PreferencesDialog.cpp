@@ -194,6 +194,12 @@ PreferencesDialog::PreferencesDialog(const QLatin1String &section, QWidget *pare
 	const int thirdPartyCookiesIndex = m_ui->thirdPartyCookiesComboBox->findData(SettingsManager::getValue(QLatin1String("Network/ThirdPartyCookiesPolicy")).toString());
 
 	m_ui->thirdPartyCookiesComboBox->setCurrentIndex((thirdPartyCookiesIndex < 0) ? 0 : thirdPartyCookiesIndex);
+	m_ui->keepCookiesUntilComboBox->addItem(tr("Expires"), QLatin1String("keepUntilExpires"));
+	m_ui->keepCookiesUntilComboBox->addItem(tr("Current session is closed"), QLatin1String("keepUntilExit"));
+
+	const int keepCookiesUntilIndex = m_ui->keepCookiesUntilComboBox->findData(SettingsManager::getValue(QLatin1String("Network/CookiesKeepMode")).toString());
+
+	m_ui->keepCookiesUntilComboBox->setCurrentIndex((keepCookiesUntilIndex < 0) ? 0 : keepCookiesUntilIndex);
 	m_ui->clearHistoryCheckBox->setChecked(!m_clearSettings.isEmpty());
 	m_ui->clearHistoryButton->setEnabled(!m_clearSettings.isEmpty());
 
@@ -1210,6 +1216,7 @@ void PreferencesDialog::save()
 	SettingsManager::setValue(QLatin1String("History/RememberDownloads"), m_ui->rememberDownloadsHistoryCheckBox->isChecked());
 	SettingsManager::setValue(QLatin1String("Browser/EnableCookies"), m_ui->acceptCookiesCheckBox->isChecked());
 	SettingsManager::setValue(QLatin1String("Network/ThirdPartyCookiesPolicy"), m_ui->thirdPartyCookiesComboBox->currentData().toString());
+	SettingsManager::setValue(QLatin1String("Network/CookiesKeepMode"), m_ui->keepCookiesUntilComboBox->currentData().toString());
 	SettingsManager::setValue(QLatin1String("History/ClearOnClose"), (m_ui->clearHistoryCheckBox->isChecked() ? m_clearSettings : QStringList()));
 
 	QList<SearchInformation*> searchEngines;
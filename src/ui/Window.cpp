@@ -23,10 +23,9 @@
 #include "GoBackActionWidget.h"
 #include "GoForwardActionWidget.h"
 #include "SearchWidget.h"
+#include "../core/FaviconsManager.h"
 #include "../core/NetworkManagerFactory.h"
 #include "../core/SettingsManager.h"
-#include "../core/WebBackend.h"
-#include "../core/WebBackendsManager.h"
 #include "../ui/WebWidget.h"
 #include "../modules/windows/bookmarks/BookmarksContentsWidget.h"
 #include "../modules/windows/cache/CacheContentsWidget.h"
@@ -593,7 +592,7 @@ QUrl Window::getUrl() const
 
 QIcon Window::getIcon() const
 {
-	return (m_contentsWidget ? m_contentsWidget->getIcon() : WebBackendsManager::getBackend()->getIconForUrl(m_session.getUrl()));
+	return (m_contentsWidget ? m_contentsWidget->getIcon() : FaviconsManager::getIcon(QUrl(m_session.getUrl())));
 }
 
 QPixmap Window::getThumbnail() const